@@ -0,0 +1,313 @@
+#include <benchmark/benchmark.h>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+class Emitter : public ObjectSlots::ObjectSlots {
+public:
+    Emitter() {
+#ifdef OBJECTSLOTS_THREADED
+        // Measures the slot storage, not the thread pool.
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_value(int value) {
+        emit( &Emitter::signal_value, value );
+    }
+
+    void signal_other(int value) {
+        emit( &Emitter::signal_other, value );
+    }
+};
+
+class Receiver {
+public:
+    void onValue(int value) { benchmark::DoNotOptimize(sum += value); }
+    long sum = 0;
+};
+
+void onValue(int value) {
+    benchmark::DoNotOptimize(value);
+}
+
+void BM_Emit(benchmark::State& state) {
+    Emitter emitter;
+    std::vector<Receiver> receivers(static_cast<std::size_t>(state.range(0)));
+    for( auto& receiver : receivers ) {
+        emitter.bind( &Emitter::signal_value, &receiver, &Receiver::onValue );
+    }
+    for( auto _ : state ) {
+        emitter.signal_value(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Emit)->Arg(0)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_EmitTyped(benchmark::State& state) {
+    Emitter emitter;
+    std::vector<Receiver> receivers(static_cast<std::size_t>(state.range(0)));
+    for( auto& receiver : receivers ) {
+        emitter.typed.bind( &receiver, &Receiver::onValue );
+    }
+    for( auto _ : state ) {
+        emitter.typed(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EmitTyped)->Arg(0)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+class Watcher : public ObjectSlots::Trackable {
+public:
+    void onValue(int value) { benchmark::DoNotOptimize(sum += value); }
+    long sum = 0;
+};
+
+// Like BM_Emit, with slots that check their receiver's liveness token.
+void BM_EmitTracked(benchmark::State& state) {
+    Emitter emitter;
+    std::vector<Watcher> watchers(static_cast<std::size_t>(state.range(0)));
+    for( auto& watcher : watchers ) {
+        emitter.bind( &Emitter::signal_value, &watcher, &Watcher::onValue );
+    }
+    for( auto _ : state ) {
+        emitter.signal_value(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EmitTracked)->Arg(1)->Arg(64)->Arg(1024);
+
+void BM_EmitAfterUnbind(benchmark::State& state) {
+    Emitter emitter;
+    std::vector<Receiver> receivers(static_cast<std::size_t>(state.range(0)));
+    std::vector<::ObjectSlots::Connection> connections;
+    for( auto& receiver : receivers ) {
+        connections.push_back( emitter.bind( &Emitter::signal_value, &receiver, &Receiver::onValue ) );
+    }
+    // Leaves every other slot empty in the array, too few to compact it.
+    for( std::size_t i = 0; i < connections.size(); i += 2 ) {
+        connections[i].disconnect();
+    }
+    for( auto _ : state ) {
+        emitter.signal_value(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+}
+BENCHMARK(BM_EmitAfterUnbind)->Arg(8)->Arg(64)->Arg(1024);
+
+class Estimator : public ObjectSlots::ObjectSlots {
+public:
+    Estimator() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    int signal_cost(int load) {
+        return collect(&Estimator::signal_cost, ::ObjectSlots::Sum<int>(), load);
+    }
+};
+
+int cost(int load) {
+    return load + 1;
+}
+
+void BM_Collect(benchmark::State& state) {
+    Estimator estimator;
+    for( long i = 0; i < state.range(0); ++i ) {
+        estimator.bind( &Estimator::signal_cost, &cost );
+    }
+    for( auto _ : state ) {
+        benchmark::DoNotOptimize(estimator.signal_cost(1));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Collect)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_EmitBatch(benchmark::State& state) {
+    Emitter emitter;
+    std::vector<Receiver> receivers(8);
+    for( auto& receiver : receivers ) {
+        emitter.typed.bind( &receiver, &Receiver::onValue );
+    }
+    const std::vector<std::tuple<int>> batch(static_cast<std::size_t>(state.range(0)), std::tuple<int>(1));
+    for( auto _ : state ) {
+        emitter.typed.emitBatch(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 8);
+}
+BENCHMARK(BM_EmitBatch)->Arg(1)->Arg(64)->Arg(1024);
+
+#ifdef OBJECTSLOTS_THREADED
+void BM_EmitWait(benchmark::State& state) {
+    Emitter emitter;
+    emitter.setEmitPolicy(Emitter::EmitPolicy::Wait);
+    std::vector<Receiver> receivers(static_cast<std::size_t>(state.range(0)));
+    for( auto& receiver : receivers ) {
+        emitter.bind( &Emitter::signal_value, &receiver, &Receiver::onValue );
+    }
+    for( auto _ : state ) {
+        emitter.signal_value(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EmitWait)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_EmitParallel(benchmark::State& state) {
+    Emitter emitter;
+    emitter.setEmitPolicy(Emitter::EmitPolicy::Parallel);
+    std::vector<Receiver> receivers(static_cast<std::size_t>(state.range(0)));
+    for( auto& receiver : receivers ) {
+        emitter.bind( &Emitter::signal_value, &receiver, &Receiver::onValue );
+    }
+    for( auto _ : state ) {
+        emitter.signal_value(1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EmitParallel)->Arg(1)->Arg(64)->Arg(1024)->Arg(16384);
+#endif
+
+void BM_BindUnbindConnection(benchmark::State& state) {
+    Emitter emitter;
+    Receiver receiver;
+    for( auto _ : state ) {
+        ::ObjectSlots::Connection connection = emitter.bind( &Emitter::signal_value, &receiver, &Receiver::onValue );
+        connection.disconnect();
+    }
+}
+BENCHMARK(BM_BindUnbindConnection);
+
+void BM_BindUnbindFunction(benchmark::State& state) {
+    Emitter emitter;
+    for( auto _ : state ) {
+        emitter.bind( &Emitter::signal_value, &onValue );
+        emitter.unbind( &onValue );
+    }
+}
+BENCHMARK(BM_BindUnbindFunction);
+
+// Wires `range(0)` receivers of mixed priorities to a new emitter, one bind
+// at a time or, if `range(1)` is set, in one transaction.
+void BM_Wire(benchmark::State& state) {
+    std::vector<Receiver> receivers(static_cast<std::size_t>(state.range(0)));
+    for( auto _ : state ) {
+        Emitter emitter;
+        {
+            ::ObjectSlots::Transaction wiring(emitter);
+            if( !state.range(1) ) {
+                wiring.commit();
+            }
+            for( std::size_t i = 0; i < receivers.size(); ++i ) {
+                emitter.bind( &Emitter::signal_value, &receivers[i], &Receiver::onValue,
+                    i % 2 ? Emitter::Priority::High : Emitter::Priority::Normal );
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Wire)->Args({1024, 0})->Args({1024, 1})->Args({16384, 0})->Args({16384, 1});
+
+// Unbinds one receiver with 8 connections from an emitter that holds
+// `range(0)` further connections of other receivers.
+void BM_UnbindObject(benchmark::State& state) {
+    Emitter emitter;
+    std::vector<Receiver> others(static_cast<std::size_t>(state.range(0)));
+    for( std::size_t i = 0; i < others.size(); ++i ) {
+        if( i % 2 ) {
+            emitter.bind( &Emitter::signal_value, &others[i], &Receiver::onValue );
+        } else {
+            emitter.bind( &Emitter::signal_other, &others[i], &Receiver::onValue );
+        }
+    }
+    Receiver receiver;
+    for( auto _ : state ) {
+        state.PauseTiming();
+        for( int i = 0; i < 8; ++i ) {
+            emitter.bind( &Emitter::signal_value, &receiver, &Receiver::onValue );
+        }
+        state.ResumeTiming();
+        emitter.unbind( &receiver );
+    }
+}
+BENCHMARK(BM_UnbindObject)->Arg(0)->Arg(64)->Arg(1024)->Arg(16384);
+
+Emitter& sharedEmitter() {
+    static Emitter emitter;
+    static bool bound = [] {
+        for( int i = 0; i < 8; ++i ) {
+            emitter.bind( &Emitter::signal_value, &onValue );
+        }
+        return true;
+    }();
+    (void)bound;
+    return emitter;
+}
+
+// Every thread emits the same signal of a shared emitter. Without thread
+// safety nothing synchronizes emits, a single thread is measured.
+void BM_ContendedEmit(benchmark::State& state) {
+    Emitter& emitter = sharedEmitter();
+    for( auto _ : state ) {
+        emitter.signal_value(1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+#ifdef OBJECTSLOTS_THREAD_SAFE
+BENCHMARK(BM_ContendedEmit)->ThreadRange(1, 64)->UseRealTime();
+#else
+BENCHMARK(BM_ContendedEmit)->Threads(1)->UseRealTime();
+#endif
+
+#ifdef OBJECTSLOTS_THREAD_SAFE
+// Binds race with emits, shards only exist with locks anyway.
+class Hub : public ObjectSlots::ObjectSlots {
+public:
+    explicit Hub(std::size_t shards) : ObjectSlots(Shards{shards}) {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+        for( auto& signal : signals ) {
+            signal.reset(new ::ObjectSlots::Signal<int>(this));
+            signal->bind( &onValue );
+        }
+    }
+
+    std::unique_ptr<::ObjectSlots::Signal<int>> signals[64];
+};
+
+// Every thread emits a signal of its own of a shared emitter, while the
+// first one keeps binding and unbinding another.
+void BM_ContendedSignals(benchmark::State& state) {
+    static Hub* hub = nullptr;
+    if( state.thread_index() == 0 ) {
+        hub = new Hub(static_cast<std::size_t>(state.range(0)));
+    }
+    Receiver receiver;
+    for( auto _ : state ) {
+        if( state.thread_index() == 0 ) {
+            ::ObjectSlots::Connection connection = hub->signals[63]->bind( &receiver, &Receiver::onValue );
+            connection.disconnect();
+        } else {
+            (*hub->signals[state.thread_index()])(1);
+        }
+    }
+    // Every thread has left the loop by now.
+    if( state.thread_index() == 0 ) {
+        state.SetItemsProcessed(state.iterations());
+        delete hub;
+    }
+}
+BENCHMARK(BM_ContendedSignals)->Arg(1)->Arg(32)->ThreadRange(2, 32)->UseRealTime();
+#endif
+
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,98 @@
+#ifndef _OBJECTSLOTS_COALESCER_HPP_
+#define _OBJECTSLOTS_COALESCER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace ObjectSlots {
+
+class EventLoop;
+
+/**
+ * @brief `Coalescer` collects the emits of coalescing connections until
+ *        they are flushed.
+ *
+ * A slot bound with a coalescer is not invoked by `emit()`. The emit only
+ * replaces the arguments it remembers for that connection, so any number of
+ * emits between two flushes invoke the slot once, with the latest arguments.
+ * Pending slots are invoked by `flush()`, by `poll()` once the time budget
+ * is used up, or on the next turn of an `EventLoop`.
+ *
+ * The slots run on the thread that flushes. A slot that is unbound before
+ * the flush is not invoked.
+ *
+ * Example Usage:
+ * ```cpp
+ * ObjectSlots::Coalescer coalescer(std::chrono::milliseconds(16));
+ * emitter.bind(&MyEmitter::valueChanged, &receiver, &MyReceiver::memberFunctionSlot, coalescer);
+ * for( int i = 0; i < 1000; ++i ) {
+ *     emitter.valueChanged(i);
+ * }
+ * coalescer.flush();  // the slot runs once, with 999
+ * ```
+ */
+class Coalescer {
+public:
+    /**
+     * @brief A connection with pending arguments, implemented by coalescing slots.
+     */
+    class Pending : public std::enable_shared_from_this<Pending> {
+    public:
+        virtual ~Pending() = default;
+
+        /**
+         * @brief Invokes the slot with the latest arguments and forgets them.
+         * @return False if the slot was unbound meanwhile and not invoked.
+         */
+        virtual bool fire() = 0;
+    };
+
+    /**
+     * @param budget How long `poll()` lets emits collapse, counted from the
+     *               first emit after a flush.
+     */
+    explicit Coalescer(std::chrono::nanoseconds budget = std::chrono::nanoseconds::zero());
+
+    /**
+     * @brief Flushes on the next turn of `loop` after an emit. The coalescer
+     *        must outlive the events it posts to the loop.
+     */
+    explicit Coalescer(EventLoop& loop);
+
+    ~Coalescer();
+
+    Coalescer(const Coalescer&) = delete;
+    Coalescer& operator=(const Coalescer&) = delete;
+
+    /**
+     * @brief Invokes every pending slot on the calling thread.
+     * @return The number of slots invoked.
+     */
+    std::size_t flush();
+
+    /**
+     * @brief Flushes if the time budget has elapsed since the first pending emit.
+     * @return The number of slots invoked.
+     */
+    std::size_t poll();
+
+    /**
+     * @brief Returns the number of connections waiting for a flush.
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Queues a connection for the next flush. Called by a coalescing
+     *        slot on the first emit after a flush.
+     */
+    void schedule(std::weak_ptr<Pending> pending);
+
+private:
+    struct impl;
+    impl* impl_;
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_COALESCER_HPP_
@@ -0,0 +1,192 @@
+#ifndef _OBJECTSLOTS_COMBINERS_HPP_
+#define _OBJECTSLOTS_COMBINERS_HPP_
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ObjectSlots {
+
+/**
+ * @brief Combiners fold the results of the slots of one `ObjectSlots::collect()`.
+ *
+ * A combiner is any class with two members:
+ * - `bool add(R value)` is called with the result of every slot, in the order
+ *   the slots run. Returning false stops the emit, the remaining slots are
+ *   not invoked.
+ * - `result()` returns what `collect()` returns, once every slot was added or
+ *   `add()` stopped the emit.
+ *
+ * Under any emit policy but `Inline`, slots run on the dispatcher in waves of
+ * `grainSize()`, and `add()` only stops the waves after the current one. A
+ * combiner that declares `static constexpr bool shortCircuits = true` has its
+ * slots run one at a time on the emitting thread instead, whatever the
+ * policy, so no slot after the one that stopped the emit is invoked.
+ *
+ * Example Usage:
+ * ```cpp
+ * class Voter : public ObjectSlots::ObjectSlots {
+ * public:
+ *     bool signal_allowed(const Request& request) {
+ *         return collect(&Voter::signal_allowed, ObjectSlots::AllOf(), request);
+ *     }
+ * };
+ * ```
+ */
+
+/**
+ * @brief True if a combiner declares `shortCircuits`, see above.
+ */
+template<class Combiner, class = void>
+struct ShortCircuits : std::false_type { };
+
+template<class Combiner>
+struct ShortCircuits<Combiner, std::void_t<decltype(Combiner::shortCircuits)>>
+    : std::bool_constant<Combiner::shortCircuits> { };
+
+/**
+ * @brief The result of the first slot; the others are not invoked.
+ */
+template<class R>
+class First {
+public:
+    static constexpr bool shortCircuits = true;
+    bool add(R value) {
+        value_.emplace(std::move(value));
+        return false;
+    }
+    std::optional<R> result() { return std::move(value_); }
+private:
+    std::optional<R> value_;
+};
+
+/**
+ * @brief The result of the last slot.
+ */
+template<class R>
+class Last {
+public:
+    bool add(R value) {
+        value_.emplace(std::move(value));
+        return true;
+    }
+    std::optional<R> result() { return std::move(value_); }
+private:
+    std::optional<R> value_;
+};
+
+/**
+ * @brief The sum of the results of all slots, `initial` without any.
+ */
+template<class R>
+class Sum {
+public:
+    explicit Sum(R initial = R()) : total_(std::move(initial)) { }
+    bool add(R value) {
+        total_ += std::move(value);
+        return true;
+    }
+    R result() { return std::move(total_); }
+private:
+    R total_;
+};
+
+/**
+ * @brief The smallest result, the first of equal ones.
+ */
+template<class R>
+class Min {
+public:
+    bool add(R value) {
+        if( !value_ || value < *value_ ) {
+            value_.emplace(std::move(value));
+        }
+        return true;
+    }
+    std::optional<R> result() { return std::move(value_); }
+private:
+    std::optional<R> value_;
+};
+
+/**
+ * @brief The largest result, the first of equal ones.
+ */
+template<class R>
+class Max {
+public:
+    bool add(R value) {
+        if( !value_ || *value_ < value ) {
+            value_.emplace(std::move(value));
+        }
+        return true;
+    }
+    std::optional<R> result() { return std::move(value_); }
+private:
+    std::optional<R> value_;
+};
+
+/**
+ * @brief True if every slot returns true, stops at the first that does not.
+ *        True without any slot.
+ */
+class AllOf {
+public:
+    static constexpr bool shortCircuits = true;
+    bool add(bool value) {
+        all_ = value;
+        return value;
+    }
+    bool result() const { return all_; }
+private:
+    bool all_ = true;
+};
+
+/**
+ * @brief True if any slot returns true, stops at the first that does.
+ *        False without any slot.
+ */
+class AnyOf {
+public:
+    static constexpr bool shortCircuits = true;
+    bool add(bool value) {
+        any_ = value;
+        return !value;
+    }
+    bool result() const { return any_; }
+private:
+    bool any_ = false;
+};
+
+/**
+ * @brief The first result `predicate` accepts; the slots after it are not invoked.
+ *        Made by `firstMatch()`.
+ */
+template<class R, class Predicate>
+class FirstMatch {
+public:
+    static constexpr bool shortCircuits = true;
+    explicit FirstMatch(Predicate predicate) : predicate_(std::move(predicate)) { }
+    bool add(R value) {
+        if( !predicate_(static_cast<const R&>(value)) ) {
+            return true;
+        }
+        value_.emplace(std::move(value));
+        return false;
+    }
+    std::optional<R> result() { return std::move(value_); }
+private:
+    Predicate predicate_;
+    std::optional<R> value_;
+};
+
+/**
+ * @brief Makes a `FirstMatch` combiner, e.g. `firstMatch<int>([](int v) { return v != 0; })`.
+ */
+template<class R, class Predicate>
+FirstMatch<R, Predicate> firstMatch(Predicate predicate) {
+    return FirstMatch<R, Predicate>(std::move(predicate));
+}
+
+} // end namespace Slots
+
+#endif // _OBJECTSLOTS_COMBINERS_HPP_
@@ -0,0 +1,65 @@
+#ifndef _OBJECTSLOTS_CONNECTIONPOOL_HPP_
+#define _OBJECTSLOTS_CONNECTIONPOOL_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "ObjectSlots/ObjectSlots.hpp"
+
+namespace ObjectSlots {
+
+/**
+ * @brief `ConnectionPool` is a memory resource tuned for slot storage.
+ *
+ * Slot arrays grow in multiples of `sizeof(SlotStorage)` and callables
+ * that do not fit inline are allocated as `SlotCallable` objects, so nearly
+ * every request falls into a handful of small size classes. The pool keeps
+ * free lists for these classes and hands out blocks carved from larger
+ * chunks; requests above `LargestBlock` go to the upstream resource.
+ *
+ * A pool may be dedicated to one emitter or shared by a group of them, it
+ * must outlive every emitter using it. It is thread safe in builds with
+ * thread safety enabled.
+ *
+ * Example Usage:
+ * ```cpp
+ * ObjectSlots::ConnectionPool pool;
+ * class Widget : public ObjectSlots::ObjectSlots {
+ * public:
+ *     explicit Widget(std::pmr::memory_resource* pool) : ObjectSlots(pool) { }
+ * };
+ * Widget widget(&pool);
+ * ```
+ */
+class ConnectionPool : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief The largest block served from the pool's own size classes.
+     */
+    static constexpr std::size_t LargestBlock = 64 * sizeof(SlotStorage);
+
+    /**
+     * @param upstream The resource chunks and large blocks are allocated from.
+     */
+    explicit ConnectionPool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    std::pmr::memory_resource* upstream() const { return pool_.upstream_resource(); }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::pmr::synchronized_pool_resource pool_;
+#else
+    std::pmr::unsynchronized_pool_resource pool_;
+#endif
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_CONNECTIONPOOL_HPP_
@@ -0,0 +1,278 @@
+#ifndef _OBJECTSLOTS_DISPATCHER_HPP_
+#define _OBJECTSLOTS_DISPATCHER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ObjectSlots {
+
+/**
+ * @brief `TaskGroup` tracks a set of tasks submitted to a `Dispatcher`
+ *        so the submitter can wait for all of them to finish.
+ *
+ * A group may be reused once it is done. It must outlive every task
+ * that was submitted with it.
+ */
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Returns true when every task submitted with this group has finished.
+     */
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class Dispatcher;
+    friend class Completion;
+
+    void add(std::size_t count = 1) { pending_.fetch_add(count, std::memory_order_relaxed); }
+    void finish();
+
+    std::atomic<std::size_t> pending_{0};
+    std::mutex mutex_;
+    std::condition_variable finished_;
+};
+
+/**
+ * @brief `WorkerGroup` describes workers of a `Dispatcher` that share a set of CPUs.
+ */
+struct WorkerGroup {
+    /** @brief The name `Dispatcher::findGroup()` looks the group up by. */
+    std::string name;
+    /** @brief The CPUs the workers are pinned to, on Linux. Empty leaves them unpinned. */
+    std::vector<unsigned> cpus;
+    /** @brief The number of workers, zero for one per CPU, at least one. */
+    std::size_t workers = 0;
+};
+
+/**
+ * @brief `Dispatcher` is a fixed-size pool of worker threads used to
+ *        invoke slots off the emitting thread.
+ *
+ * Every worker owns a task queue. Tasks submitted from a worker are pushed
+ * onto that worker's queue, tasks submitted from any other thread are
+ * spread round-robin over all queues. An idle worker first drains its own
+ * queue (newest first) and then steals the oldest task from the other
+ * workers' queues.
+ *
+ * The workers may be split into groups, each pinned to a set of CPUs, for
+ * example one per NUMA node with `nodes()`. A task submitted to a group has
+ * a queue of the group and only its workers run it, so the memory it
+ * touches stays local to their node. Tasks without a group run anywhere.
+ *
+ * Emitters share their dispatcher through a `std::shared_ptr`, a pending
+ * `Completion` keeps it alive as well.
+ *
+ * Example Usage:
+ * ```cpp
+ * auto pool = std::make_shared<ObjectSlots::Dispatcher>(4);
+ * emitter.setDispatcher(pool);              // per instance
+ * ObjectSlots::Dispatcher::setGlobal(pool); // for emitters created from now on
+ *
+ * auto pinned = std::make_shared<ObjectSlots::Dispatcher>(ObjectSlots::Dispatcher::nodes());
+ * ```
+ */
+class Dispatcher : public std::enable_shared_from_this<Dispatcher> {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Submits a task to no group in particular, any worker runs it.
+     */
+    static constexpr std::size_t AnyGroup = ~std::size_t(0);
+
+    /**
+     * @brief Submits a task to the group `currentGroup()` returns for the
+     *        submitting thread, or to any worker if there is none.
+     */
+    static constexpr std::size_t CallerGroup = AnyGroup - 1;
+
+    /**
+     * @brief Starts the worker threads.
+     * @param workers The number of worker threads. Zero selects
+     *                `std::thread::hardware_concurrency()`.
+     */
+    explicit Dispatcher(std::size_t workers = 0);
+
+    /**
+     * @brief Starts the workers of every group, the first group has index zero.
+     * @param groups The groups, at least one.
+     */
+    explicit Dispatcher(std::vector<WorkerGroup> groups);
+
+    /**
+     * @brief Runs every task that is still queued and joins the workers.
+     */
+    ~Dispatcher();
+
+    Dispatcher(const Dispatcher&) = delete;
+    Dispatcher& operator=(const Dispatcher&) = delete;
+
+    /**
+     * @brief Queues a task for execution on one of the workers.
+     * @param task The task to run.
+     * @param group An optional group that is notified when the task finished.
+     * @param workers The index of the worker group to run it, `CallerGroup`,
+     *                or `AnyGroup`. An index past the last group means any worker.
+     */
+    void submit(Task task, TaskGroup* group = nullptr, std::size_t workers = AnyGroup);
+
+    /**
+     * @brief Blocks until every task of the group has finished.
+     *
+     * While waiting, the calling thread runs queued tasks itself, so
+     * waiting from inside a task never starves the pool.
+     * @param group The group to wait for.
+     */
+    void wait(TaskGroup& group);
+
+    /**
+     * @brief Returns the number of worker threads.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Returns the number of worker groups.
+     */
+    std::size_t groupCount() const;
+
+    /**
+     * @brief Returns a worker group as it was created, with its worker count.
+     */
+    const WorkerGroup& group(std::size_t index) const;
+
+    /**
+     * @brief Returns the index of the first group of that name, or `AnyGroup`.
+     */
+    std::size_t findGroup(std::string_view name) const;
+
+    /**
+     * @brief Returns the group of the calling worker, or of the CPU the
+     *        calling thread runs on. `AnyGroup` if no group has it.
+     */
+    std::size_t currentGroup() const;
+
+    /**
+     * @brief Returns one group named `node<N>` per NUMA node, with the CPUs of
+     *        the node the process may run on and one worker each. Without NUMA
+     *        information it is a single unpinned `node0`.
+     */
+    static std::vector<WorkerGroup> nodes();
+
+    /**
+     * @brief Returns the process-wide dispatcher, creating it on first use.
+     */
+    static std::shared_ptr<Dispatcher> global();
+
+    /**
+     * @brief Replaces the process-wide dispatcher.
+     *
+     * Emitters pick up the process-wide dispatcher when they are constructed,
+     * so this only affects emitters created afterwards.
+     * @param dispatcher The new process-wide dispatcher.
+     */
+    static void setGlobal(std::shared_ptr<Dispatcher> dispatcher);
+
+private:
+    struct impl;
+    impl* impl_;
+};
+
+/**
+ * @brief `Completion` is the token returned by `emitAsync()`. It tells when
+ *        every slot invoked by that emit has finished.
+ *
+ * The token can be polled, waited for or simply dropped, the invocations run
+ * to completion either way. Copies refer to the same emit. A default
+ * constructed token is complete.
+ *
+ * Built with C++20 coroutines, a token can be awaited with `co_await`. The
+ * coroutine is resumed on one of the dispatcher's workers.
+ */
+class Completion {
+public:
+    Completion() = default;
+
+    /**
+     * @brief Returns true when every slot of the emit has finished.
+     */
+    bool ready() const;
+
+    /**
+     * @brief Blocks until every slot of the emit has finished. Like
+     *        `Dispatcher::wait()`, the calling thread runs queued tasks meanwhile.
+     */
+    void wait() const;
+
+    /**
+     * @brief Blocks until every slot of the emit has finished or the timeout expired.
+     * @return True if the emit finished.
+     */
+    bool waitFor(std::chrono::nanoseconds timeout) const;
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    struct Awaiter;
+    Awaiter operator co_await() const;
+#endif
+
+private:
+    friend class ObjectSlots;
+    struct State;
+
+    explicit Completion(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    /**
+     * @brief Starts tracking `tasks` invocations that will run on `dispatcher`.
+     */
+    static Completion make(std::shared_ptr<Dispatcher> dispatcher, std::size_t tasks);
+
+    /**
+     * @brief Called by each invocation once it finished.
+     */
+    static void finish(State& state);
+
+    /**
+     * @brief Runs `resume` once the emit finished.
+     * @return False if it already had, `resume` is not stored then.
+     */
+    bool suspend(std::function<void()> resume) const;
+
+    std::shared_ptr<State> state_;
+};
+
+} // end namespace Slots
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+
+namespace ObjectSlots {
+
+struct Completion::Awaiter {
+    Completion completion;
+
+    bool await_ready() const { return completion.ready(); }
+    bool await_suspend(std::coroutine_handle<> handle) const {
+        return completion.suspend([handle]() { handle.resume(); });
+    }
+    void await_resume() const {}
+};
+
+inline Completion::Awaiter Completion::operator co_await() const {
+    return Awaiter{ *this };
+}
+
+} // end namespace Slots
+#endif
+
+#endif //_OBJECTSLOTS_DISPATCHER_HPP_
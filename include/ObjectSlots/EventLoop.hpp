@@ -0,0 +1,92 @@
+#ifndef _OBJECTSLOTS_EVENTLOOP_HPP_
+#define _OBJECTSLOTS_EVENTLOOP_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+
+namespace ObjectSlots {
+
+/**
+ * @brief `EventLoop` delivers queued slot invocations on the thread that
+ *        processes it.
+ *
+ * Any number of threads post events into a bounded lock-free queue, and
+ * one thread at a time drains it with `processEvents()` or `run()`. A
+ * slot bound with an event loop is not invoked by `emit()`. Instead the
+ * emit copies its arguments into an event, so the emitter never waits for
+ * the receiver's work.
+ *
+ * The receiver of a queued slot must outlive the events already posted for
+ * it. Events still queued when the loop is destroyed are dropped.
+ *
+ * Example Usage:
+ * ```cpp
+ * ObjectSlots::EventLoop loop;
+ * emitter.bind(&MyEmitter::valueChanged, &receiver, &MyReceiver::memberFunctionSlot, loop);
+ * std::thread ui([&loop]() { loop.run(); });
+ * emitter.valueChanged(42);  // returns at once, the slot runs on `ui`
+ * loop.quit();
+ * ui.join();
+ * ```
+ */
+class EventLoop {
+public:
+    using Event = std::function<void()>;
+
+    /**
+     * @param capacity The number of events the queue holds, rounded up to a power of two.
+     */
+    explicit EventLoop(std::size_t capacity = 1024);
+
+    /**
+     * @brief Drops the events that were not processed.
+     */
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Queues an event, yielding while the queue is full.
+     */
+    void post(Event event);
+
+    /**
+     * @brief Queues an event unless the queue is full.
+     * @return False if the queue was full, `event` is left untouched then.
+     */
+    bool tryPost(Event& event);
+
+    /**
+     * @brief Runs the queued events on the calling thread.
+     *        Only one thread may process a loop at a time.
+     * @param max The most events to run. Events posted while processing
+     *            are run as well, up to this number.
+     * @return The number of events run.
+     */
+    std::size_t processEvents(std::size_t max = std::numeric_limits<std::size_t>::max());
+
+    /**
+     * @brief Processes events until `quit()` is called, sleeping while the queue is empty.
+     */
+    void run();
+
+    /**
+     * @brief Makes `run()` return once the events queued so far are processed.
+     */
+    void quit();
+
+    /**
+     * @brief Returns the number of events the queue holds.
+     */
+    std::size_t capacity() const;
+
+private:
+    struct impl;
+    impl* impl_;
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_EVENTLOOP_HPP_
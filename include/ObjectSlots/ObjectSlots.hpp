@@ -1,15 +1,40 @@
 #ifndef _OBJECTSLOTS_HPP_
 #define _OBJECTSLOTS_HPP_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #ifdef OBJECTSLOTS_ENABLE_THREADS
 #define OBJECTSLOTS_THREADED
-#include <stack>
-#include <thread>
+#include <atomic>
+#include "ObjectSlots/Dispatcher.hpp"
 #endif
 #ifdef OBJECTSLOTS_ENABLE_THREAD_SAFETY
 #define OBJECTSLOTS_THREAD_SAFE
+#include <atomic>
+#ifdef OBJECTSLOTS_ENABLE_LOCK_FREE_EMIT
+#define OBJECTSLOTS_LOCK_FREE
 #endif
+#endif
+#ifdef OBJECTSLOTS_ENABLE_STATS
+#define OBJECTSLOTS_STATS
+#include <chrono>
+#include "ObjectSlots/Stats.hpp"
+#endif
+#include "ObjectSlots/Coalescer.hpp"
+#include "ObjectSlots/Combiners.hpp"
+#include "ObjectSlots/EventLoop.hpp"
+#include "ObjectSlots/Trace.hpp"
 
 namespace ObjectSlots {
 
@@ -23,8 +48,15 @@ template<class ReturnType, class ... Args>
 using SlotLambdaP = ReturnType (*)(Args...);
 
 /**
- * @brief `Base` class to handle slots of either Class/Method
- * or plain functions.
+ * @brief How an argument of type `T` is handed to every slot: reference
+ *        arguments as they are, all others as a const reference to the one
+ *        object the emitter passed in, so emitting copies nothing per slot.
+ */
+template<class T>
+using SlotArg = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+/**
+ * @brief `Base` class to handle slots that are stored on the heap.
  * @tparam ReturnType The return type of the slot.
  * @tparam Args The argument types of the slot.
  */
@@ -41,7 +73,6 @@ public:
 
     /**
      * @brief Returns a pointer to the object associated with the slot.
-     *        For SlotFunction, this will always be nullptr.
      * @return A void pointer to the object, or nullptr if not applicable.
      */
     virtual const void* object() const { return nullptr; }
@@ -58,17 +89,18 @@ public:
      * @param args The arguments to pass to the slot.
      * @return The return value of the slot.
      */
-    virtual ReturnType operator()(Args... args) const = 0;
+    virtual ReturnType operator()(SlotArg<Args>... args) const = 0;
 };
 
 /**
  * @brief `SlotMethod` class to handle slots of Class/Method.
+ *        It is a plain value, small enough to be stored inline by `SlotStorage`.
  * @tparam T The class type of the object owning the method.
  * @tparam ReturnType The return type of the method.
  * @tparam Args The argument types of the method.
  */
 template<class T, class ReturnType, class ... Args>
-class SlotMethod : public Base<ReturnType, Args...> {
+class SlotMethod {
 private:
     T* object_;
     SlotMethodP<T, ReturnType, Args...> callback_;
@@ -76,8 +108,8 @@ public:
     SlotMethod(T* object, SlotMethodP<T, ReturnType, Args...> callback)
         : object_(object), callback_(callback) {}
 
-    const void* object() const override { return object_; }
-    const void* callback() const override {
+    const void* object() const { return object_; }
+    const void* callback() const {
         union {
             SlotMethodP<T, ReturnType, Args...> signal_ptr;
             const void *ptr;
@@ -86,18 +118,19 @@ public:
         return to_void_ptr.ptr;
     }
 
-    ReturnType operator()(Args... args) const override {
+    ReturnType operator()(SlotArg<Args>... args) const {
         return (object_->*callback_)(args...);
     }
 };
 
 /**
  * @brief `SlotFunction` class to handle slots of plain functions.
+ *        It is a plain value, small enough to be stored inline by `SlotStorage`.
  * @tparam ReturnType The return type of the function.
  * @tparam Args The argument types of the function.
  */
 template<class ReturnType, class ... Args>
-class SlotFunction : public Base<ReturnType, Args...> {
+class SlotFunction {
 private:
     SlotFunctionP<ReturnType, Args...> callback_;
 
@@ -105,267 +138,2292 @@ public:
     SlotFunction(SlotFunctionP<ReturnType, Args...> callback)
         : callback_(callback) {}
 
-    const void* object() const override { return nullptr; }
-    const void* callback() const override { return reinterpret_cast<void*>(callback_); }
+    const void* object() const { return nullptr; }
+    const void* callback() const { return reinterpret_cast<void*>(callback_); }
 
-    ReturnType operator()(Args... args) const override {
+    ReturnType operator()(SlotArg<Args>... args) const {
         return callback_(args...);
     }
 };
 
-template<class ReturnType, class ... Args>
-class SlotLambda : Base<ReturnType, Args...> {
+/**
+ * @brief True if the slot type `F` wants to be told when its connection is
+ *        removed, through a `disconnected()` member.
+ */
+template<class F, class = void>
+struct Disconnectable : std::false_type {};
+
+template<class F>
+struct Disconnectable<F, std::void_t<decltype(std::declval<const F&>().disconnected())>> : std::true_type {};
+
+/**
+ * @brief `SlotCallable` class to handle callables that are too large
+ *        to be stored inline by `SlotStorage`. It holds the closure itself,
+ *        so a call costs one indirect jump through `Base`.
+ * @tparam F The type of the callable.
+ * @tparam ReturnType The return type of the signal.
+ * @tparam Args The argument types of the signal.
+ */
+template<class F, class ReturnType, class ... Args>
+class SlotCallable : public Base<ReturnType, Args...> {
 private:
-    std::function<ReturnType(Args...)> lambda_;
+    // Callables with a mutable call operator are invoked like they
+    // were through a std::function.
+    mutable F callable_;
     const void *callback_;
-    using self_type = SlotLambda<ReturnType, Args...>;
 public:
-    SlotLambda(std::function<ReturnType(Args...)> lambda, const void* cb) :
-        lambda_(lambda), callback_(cb)
+    template<class Callable>
+    SlotCallable(Callable&& callable, const void* cb) :
+        callable_(std::forward<Callable>(callable)), callback_(cb)
     { }
 
-    ReturnType operator()(Args ... args) const override {
-        return lambda_(args...);
+    ReturnType operator()(SlotArg<Args>... args) const override {
+        if constexpr( std::is_void_v<ReturnType> ) {
+            callable_(args...);
+        } else {
+            return callable_(args...);
+        }
     }
 
     const void* object() const override { return this; }
     const void* callback() const override { return callback_; }
+
+    void disconnected() const {
+        if constexpr( Disconnectable<F>::value ) {
+            callable_.disconnected();
+        }
+    }
 };
 
 /**
- * @brief `ObjectSlots` is a base class that provides signal/slot functionality.
- *        Derived classes can emit signals, and other objects or functions can bind to these signals as slots.
- *
- * Example Usage:
- * ```cpp
- * #include <iostream>
- * #include <slots/slots.hpp>
- *
- * class MyEmitter : public Slots::ObjectSlots {
- * public:
- *     void valueChanged(int newValue) {
- *         emit(&MyEmitter::valueChanged, newValue);
- *     }
- * };
- *
- * void globalFunctionSlot(int value) {
- *     std::cout << "Global function received: " << value << std::endl;
- * }
- *
- * class MyReceiver {
- * public:
- *     void memberFunctionSlot(int value) {
- *         std::cout << "Member function received: " << value << std::endl;
- *     }
- * };
+ * @brief `Batch` is a view of the argument tuples of one `emitBatch()`.
+ *        A batch slot receives it directly, every other slot is invoked
+ *        once per element.
  *
- * int main() {
- *     MyEmitter emitter;
- *     MyReceiver receiver;
- *     emitter.bind(&MyEmitter::valueChanged, &globalFunctionSlot);
- *     emitter.bind(&MyEmitter::valueChanged, &receiver, &MyReceiver::memberFunctionSlot);
- *     emitter.valueChanged(42); // This will call both slots
- *     return 0;
- * }
- * ```
+ * The elements are const, so only signals whose arguments are values or
+ * const references can emit a batch. A slot of a `Signal<int&>` could
+ * not write back through its reference.
+ * @tparam Args The argument types of the signal.
  */
-class ObjectSlots {
+template<class ... Args>
+class Batch {
+public:
+    using Element = std::tuple<std::decay_t<Args>...>;
+
+    Batch(const Element* data, std::size_t size) : data_(data), size_(size) {}
+
+    /**
+     * @brief Views a contiguous container of elements, e.g. a `std::vector` or `std::array`.
+     */
+    template<class Container, typename = std::enable_if_t<
+        std::is_convertible_v<decltype(std::declval<const Container&>().data()), const Element*>>>
+    Batch(const Container& container) : data_(container.data()), size_(container.size()) {}
+
+    const Element* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const Element* begin() const { return data_; }
+    const Element* end() const { return data_ + size_; }
+    const Element& operator[](std::size_t index) const { return data_[index]; }
+
 private:
-    using LockP = void*;
+    const Element* data_;
+    std::size_t size_;
+};
+
+/**
+ * @brief `BatchBase` is the heap slot of a batch-aware slot. Single emits
+ *        reach it as a batch of one element.
+ * @tparam Args The argument types of the signal.
+ */
+template<class ... Args>
+class BatchBase : public Base<void, Args...> {
 public:
-    ObjectSlots();
-    virtual ~ObjectSlots();
+    virtual void invokeBatch(const Batch<Args...>& batch) const = 0;
+};
 
-    template<class SignalType, class ReturnType, typename Func, class ... Args>
-    void bind(
-        SlotMethodP<SignalType, ReturnType, Args...> signal,
-        //T* object,
-        Func&& f)
-    {
-        union {
-            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
-            void *ptr;
-        } to_void_ptr;
-        to_void_ptr.signal_ptr = signal;
-        SlotLambda<ReturnType, Args...>* lambda = new SlotLambda<ReturnType, Args...>(f, &f);
-        slotStore(to_void_ptr.ptr, lambda);
+/**
+ * @brief `SlotBatch` binds a function or method taking a `Batch`.
+ * @tparam Target A `SlotMethod` or `SlotFunction` taking a `const Batch<Args...>&`.
+ * @tparam Args The argument types of the signal.
+ */
+template<class Target, class ... Args>
+class SlotBatch : public BatchBase<Args...> {
+private:
+    Target target_;
+
+public:
+    explicit SlotBatch(const Target& target) : target_(target) {}
+
+    void operator()(SlotArg<Args>... args) const override {
+        const typename Batch<Args...>::Element element(args...);
+        target_(Batch<Args...>(&element, 1));
     }
 
-    template<typename Func>
-    void unbind(Func&& f) {
-        slotRemove(nullptr, &f);
+    void invokeBatch(const Batch<Args...>& batch) const override {
+        target_(batch);
+    }
+
+    const void* object() const override { return target_.object(); }
+    const void* callback() const override { return target_.callback(); }
+};
+
+class Connection;
+class ObjectSlots;
+
+/**
+ * @brief `SlotQueued` wraps the target of a queued connection. Invoking it
+ *        copies the arguments and posts the call of `Target` to an `EventLoop`.
+ *        A queued function is small enough to be stored inline by `SlotStorage`.
+ * @tparam Target The slot invoked on the loop, copied into every event.
+ * @tparam Args The argument types of the signal.
+ */
+template<class Target, class ... Args>
+class SlotQueued {
+private:
+    EventLoop* loop_;
+    Target target_;
+
+public:
+    SlotQueued(EventLoop* loop, const Target& target) : loop_(loop), target_(target) {}
+
+    void operator()(SlotArg<Args>... args) const {
+        loop_->post([target = target_, params = std::tuple<std::decay_t<Args>...>(args...)]() mutable {
+            std::apply(target, params);
+        });
     }
+};
+
+/**
+ * @brief `SlotStorage` keeps one bound slot directly in a signal's slot array.
+ *
+ * Function pointers, object/method pairs and small trivially copyable
+ * callables are stored inline, next to the thunk that invokes them, so
+ * emitting walks one contiguous array without chasing a pointer per slot.
+ * Larger callables live on the heap behind a `Base`, allocated from a
+ * `std::pmr::memory_resource`, and are deleted through `destroy()`.
+ * The storage itself is trivially copyable, so slot arrays can be
+ * copied and grown without running any constructor.
+ */
+class SlotStorage {
+public:
+    static constexpr std::size_t InlineSize = 3 * sizeof(void*);
 
     /**
-     * @brief Binds a member function slot to a signal.
-     *
-     * @tparam SignalType The class type of the object emitting the signal.
-     * @tparam ReturnType The return type of the signal and slot.
-     * @tparam T The class type of the object owning the slot method.
-     * @tparam Args The argument types of the signal and slot.
-     * @param signal A pointer to the member function representing the signal.
-     * @param object A pointer to the object instance that owns the slot method.
-     * @param callback A pointer to the member function representing the slot.
+     * @brief True if a callable of type `F` can be stored inline.
      */
-    template <class SignalType, class ReturnType, class T, class ... Args>
-    void bind(
-        SlotMethodP<SignalType, ReturnType, Args...> signal,
-        T* object,
-        SlotMethodP<T, ReturnType, Args...> callback)
-    {
-        union {
-            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
-            void *ptr;
-        } to_void_ptr;
-        to_void_ptr.signal_ptr = signal;
-        SlotMethod<T, ReturnType, Args...>* method = new SlotMethod<T, ReturnType, Args...>(object, callback);
-        slotStore(to_void_ptr.ptr, method);
+    template<class F>
+    static constexpr bool fitsInline =
+        std::is_trivially_copyable_v<F> &&
+        sizeof(F) <= InlineSize &&
+        alignof(F) <= alignof(void*);
+
+    SlotStorage() = default;
+
+    /**
+     * @brief Stores a callable inline.
+     * @param callable The callable, `fitsInline<F>` must hold.
+     * @param object The object used to identify the slot on unbind.
+     * @param callback The callback used to identify the slot on unbind.
+     */
+    template<class ReturnType, class ... Args, class F>
+    static SlotStorage makeInline(const F& callable, const void* object, const void* callback) {
+        static_assert(fitsInline<F>, "callable does not fit inline");
+        SlotStorage slot;
+        slot.invoke_ = reinterpret_cast<void (*)()>(&invokeInline<F, ReturnType, Args...>);
+        slot.release_ = nullptr;
+        slot.object_ = object;
+        slot.callback_ = callback;
+        slot.batched_ = false;
+#ifdef OBJECTSLOTS_THREADED
+        slot.affinity_ = AnyWorkers;
+#endif
+        slot.priority_ = 0;
+        ::new (static_cast<void*>(slot.data_)) F(callable);
+        return slot;
     }
 
     /**
-     * @brief Binds a free function slot to a signal.
-     *
-     * @tparam SignalType The class type of the object emitting the signal.
-     * @tparam ReturnType The return type of the signal and slot.
-     * @tparam Args The argument types of the signal and slot.
-     * @param signal A pointer to the member function representing the signal.
-     * @param callback A pointer to the free function representing the slot.
+     * @brief Stores a heap allocated slot, which is owned by the storage from now on.
+     * @param heap The slot, constructed in memory allocated from `resource`.
+     * @param resource The resource `destroy()` returns the memory to.
      */
-    template <class SignalType, class ReturnType, class ... Args>
-    void bind(
-        SlotMethodP<SignalType, ReturnType, Args...> signal,
-        SlotFunctionP<ReturnType, Args...> callback)
-    {
-        union {
-            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
-            void *ptr;
-        } to_void_ptr;
-        to_void_ptr.signal_ptr = signal;
-        SlotFunction<ReturnType, Args...>* function = new SlotFunction<ReturnType, Args...>(callback);
-        slotStore(to_void_ptr.ptr, function);
+    template<class ReturnType, class ... Args, class Heap>
+    static SlotStorage makeHeap(Heap* heap, std::pmr::memory_resource* resource, const void* object, const void* callback) {
+        static_assert(std::is_base_of_v<Base<ReturnType, Args...>, Heap>, "heap slot must derive from Base");
+        SlotStorage slot;
+        slot.invoke_ = reinterpret_cast<void (*)()>(&invokeHeap<ReturnType, Args...>);
+        slot.release_ = &releaseHeap<Heap, ReturnType, Args...>;
+        slot.object_ = object;
+        slot.callback_ = callback;
+        slot.batched_ = false;
+#ifdef OBJECTSLOTS_THREADED
+        slot.affinity_ = AnyWorkers;
+#endif
+        slot.priority_ = 0;
+        ::new (static_cast<void*>(slot.data_)) HeapRef{ static_cast<Base<ReturnType, Args...>*>(heap), resource };
+        return slot;
     }
 
     /**
-     * @brief Unbinds a member function slot from all signals it might be connected to.
-     *
-     * @tparam T The class type of the object owning the slot method.
-     * @tparam ReturnType The return type of the slot.
-     * @tparam Args The argument types of the slot.
-     * @param object A pointer to the object instance that owns the slot method.
-     * @param method A pointer to the member function representing the slot.
-     *               This method will be unbound from any signal it's connected to on this ObjectSlots.
+     * @brief Stores a batch-aware slot, which `invokeBatch()` hands whole batches.
      */
-    template <class T, class ReturnType, class ... Args>
-    void unbind(T* object, SlotMethodP<T, ReturnType, Args...> method) {
-        union {
-            SlotMethodP<T, ReturnType, Args...> method_ptr;
-            void *ptr;
-        } to_void_ptr;
-        to_void_ptr.method_ptr = method;
-        slotRemove(object, to_void_ptr.ptr);
+    template<class ... Args, class Heap>
+    static SlotStorage makeBatch(Heap* heap, std::pmr::memory_resource* resource, const void* object, const void* callback) {
+        static_assert(std::is_base_of_v<BatchBase<Args...>, Heap>, "batch slot must derive from BatchBase");
+        SlotStorage slot = makeHeap<void, Args...>(heap, resource, object, callback);
+        slot.batched_ = true;
+        return slot;
     }
 
     /**
-     * @brief Unbinds a free function slot from all signals it might be connected to.
-     *
-     * @tparam ReturnType The return type of the slot.
-     * @tparam Args The argument types of the slot.
-     * @param function A pointer to the free function representing the slot.
-     *                 This function will be unbound from any signal it's connected to on this ObjectSlots.
-     *                 Note: This unbinds the specific function, not all functions.
+     * @brief Invokes the slot. `ReturnType` and `Args` must match the types it was made with.
      */
-    template <class ReturnType, class ... Args>
-    void unbind(SlotFunctionP<ReturnType, Args...> function) {
-        union {
-            SlotFunctionP<ReturnType, Args...> function_ptr;
-            void *ptr;
-        } to_void_ptr;
-        to_void_ptr.function_ptr = function;
-        slotRemove(nullptr, to_void_ptr.ptr);
+    template<class ReturnType, class ... Args>
+    ReturnType invoke(SlotArg<Args>... args) const {
+        return reinterpret_cast<Thunk<ReturnType, Args...>>(invoke_)(*this, args...);
     }
 
     /**
-     * @brief Unbinds all slots associated with a specific object.
-     *
-     * @tparam T The class type of the object.
-     * @param object A pointer to the object whose member function slots should be unbound.
-     *               All member function slots belonging to this object that are bound to any signal
-     *               on this ObjectSlots will be removed.
+     * @brief Invokes the slot over a whole batch: a batch-aware slot once,
+     *        any other slot once per element.
      */
-    template <class T>
-    void unbind(T* object) {
-        slotRemove(object, nullptr);
+    template<class ... Args>
+    void invokeBatch(const Batch<Args...>& batch) const {
+        if( batched_ ) {
+            auto base = static_cast<Base<void, Args...>*>(get<HeapRef>().heap);
+            static_cast<const BatchBase<Args...>*>(base)->invokeBatch(batch);
+            return;
+        }
+        const Thunk<void, Args...> thunk = reinterpret_cast<Thunk<void, Args...>>(invoke_);
+        for( const auto& element : batch ) {
+            std::apply([this, thunk](const auto& ... params) { thunk(*this, params...); }, element);
+        }
     }
 
     /**
-     * @brief Unbinds a specific free function slot from all signals it might be connected to.
-     * @param function A void pointer to the free function to be unbound.
+     * @brief Invokes the slot with the elements of a tuple as arguments.
      */
-    void unbind(void* function) {
-        slotRemove(nullptr, function);
+    template<class ReturnType, class ... Args, class Tuple>
+    ReturnType apply(Tuple& args) const {
+        return std::apply([this](auto& ... params) -> ReturnType {
+            return invoke<ReturnType, Args...>(params...);
+        }, args);
     }
 
-protected:
+    const void* object() const { return object_; }
+    const void* callback() const { return callback_; }
+
     /**
-     * @brief Emits a signal, invoking all bound slots.
-     *
-     * This method is intended to be called by derived classes to trigger a signal.
-     * It iterates through all slots bound to the given signal and invokes them with the provided arguments.
-     *
-     * @tparam T The class type of the object emitting the signal.
-     * @tparam Args The argument types of the signal and the slots.
-     * @param callback A pointer to the member function representing the signal being emitted.
-     * @param args The arguments to pass to the bound slots.
+     * @brief True for a value initialized storage, which holds no slot.
+     *        Disconnected slots are left empty until their array is compacted.
      */
-    template<class T, class ... Args>
-    void emit(
-        SlotMethodP<T, void, Args...> callback,
-        Args... args)
-    {
-        union {
-            SlotMethodP<T, void, Args...> signal_ptr;
-            void *ptr;
-        } to_void_ptr;
-        to_void_ptr.signal_ptr = callback;
-        int i = 0;
-#ifdef OBJECTSLOTS_THREADED
-        std::stack<std::thread> threads;
-#endif
-#ifdef OBJECTSLOTS_THREAD_SAFE
-        auto lock = acquireLock();
-#endif
-        while( void* slot = getSlot(to_void_ptr.ptr, i++) ) {
+    bool empty() const { return invoke_ == nullptr; }
+
+    /**
+     * @brief The index of the slot's entry in its emitter's connection table.
+     */
+    std::uint32_t connection() const { return connection_; }
+    void setConnection(std::uint32_t connection) { connection_ = connection; }
+
+    /**
+     * @brief The priority the slot was bound with, slot arrays are sorted by it.
+     */
+    std::int16_t priority() const { return priority_; }
+    void setPriority(std::int16_t priority) { priority_ = priority; }
+
 #ifdef OBJECTSLOTS_THREADED
-            threads.emplace( [slot, args...]() {
-                (*reinterpret_cast<Base<void, Args...>*>(slot))(args...);
-            });
-#else
-            (*reinterpret_cast<Base<void, Args...>*>(slot))(args...);
+    /** @brief The affinity of a slot any worker may run. */
+    static constexpr std::uint8_t AnyWorkers = 0xFF;
+    /** @brief The affinity of a slot that runs in the worker group of the emitting thread. */
+    static constexpr std::uint8_t CallerWorkers = 0xFE;
+
+    /**
+     * @brief The worker group of the dispatcher that runs the slot, its index
+     *        or one of `AnyWorkers` and `CallerWorkers`.
+     */
+    std::uint8_t affinity() const { return affinity_; }
+    void setAffinity(std::uint8_t affinity) { affinity_ = affinity; }
 #endif
+
+    /**
+     * @brief True if the slot owns a heap allocation that `destroy()` frees.
+     */
+    bool owning() const { return release_ != nullptr; }
+
+    /**
+     * @brief Tells an owning slot that its connection was removed, while it
+     *        may still be kept until no emit is running it.
+     */
+    void disconnect() const {
+        if( release_ ) {
+            release_(*this, Release::Disconnect);
         }
-#ifdef OBJECTSLOTS_THREAD_SAFE
-        releaseLock(lock);
-#endif
-#ifdef OBJECTSLOTS_THREADED
-        while(!threads.empty()) {
-            threads.top().join();
-            threads.pop();
+    }
+
+    /**
+     * @brief Frees the heap allocation of an owning slot, which is told it
+     *        is disconnected first. Every copy of the storage is invalid afterwards.
+     */
+    void destroy() {
+        if( release_ ) {
+            release_(*this, Release::Destroy);
         }
-#endif
     }
+
 private:
-    struct impl;
-    impl* impl_;
+    template<class ReturnType, class ... Args>
+    using Thunk = ReturnType (*)(const SlotStorage&, SlotArg<Args>...);
 
-    void* getSlot(void*, int);
-    void slotStore(void*, void*);
-    void slotRemove(void*, void*);
-#ifdef OBJECTSLOTS_THREAD_SAFE
-    LockP acquireLock();
-    void releaseLock(LockP);
+    template<class F>
+    F& get() const { return *std::launder(reinterpret_cast<F*>(data_)); }
+
+    template<class F, class ReturnType, class ... Args>
+    static ReturnType invokeInline(const SlotStorage& self, SlotArg<Args>... args) {
+        return self.get<F>()(args...);
+    }
+
+    /**
+     * @brief What an owning slot keeps inline: the slot and where its memory came from.
+     */
+    struct HeapRef {
+        void* heap;
+        std::pmr::memory_resource* resource;
+    };
+
+    template<class ReturnType, class ... Args>
+    static ReturnType invokeHeap(const SlotStorage& self, SlotArg<Args>... args) {
+        return (*static_cast<Base<ReturnType, Args...>*>(self.get<HeapRef>().heap))(args...);
+    }
+
+    enum class Release : bool { Disconnect, Destroy };
+
+    template<class Heap, class ReturnType, class ... Args>
+    static void releaseHeap(const SlotStorage& self, Release release) {
+        const HeapRef ref = self.get<HeapRef>();
+        Heap* heap = static_cast<Heap*>(static_cast<Base<ReturnType, Args...>*>(ref.heap));
+        if constexpr( Disconnectable<Heap>::value ) {
+            heap->disconnected();
+        }
+        if( release == Release::Destroy ) {
+            heap->~Heap();
+            ref.resource->deallocate(heap, sizeof(Heap), alignof(Heap));
+        }
+    }
+
+    void (*invoke_)();
+    void (*release_)(const SlotStorage&, Release);
+    const void* object_;
+    const void* callback_;
+    std::uint32_t connection_;
+    bool batched_;
+#ifdef OBJECTSLOTS_THREADED
+    std::uint8_t affinity_;
 #endif
+    std::int16_t priority_;
+    alignas(void*) mutable unsigned char data_[InlineSize];
 };
 
+static_assert(std::is_trivially_copyable_v<SlotStorage>);
+
+#ifdef OBJECTSLOTS_THREADED
+/**
+ * @brief `DetachedEmit` holds a copy of the arguments and of the slots of
+ *        one detached emit. It is shared by every slot invocation queued for
+ *        that emit and deleted by the last one to finish.
+ * @tparam Payload The arguments, a tuple for a single emit or a vector of tuples for a batch.
+ */
+template<class Payload>
+struct DetachedEmit {
+    /**
+     * @brief Copies the slots of an emit plan, `refs` starts at their number.
+     */
+    template<class ... Params>
+    DetachedEmit(const SlotStorage* first, std::size_t count, Params&& ... params)
+        : slots(first, first + count), args(std::forward<Params>(params)...), refs(count) { }
+
+    void release() {
+        if( refs.fetch_sub(1, std::memory_order_acq_rel) == 1 ) {
+            delete this;
+        }
+    }
+
+    std::vector<SlotStorage> slots;
+    Payload args;
+    std::atomic<std::size_t> refs;
+};
+#endif
+
+/**
+ * @brief `Connection` identifies one slot bound by `ObjectSlots::bind()`.
+ *
+ * It is a generational index into the emitter's connection table, so
+ * disconnecting finds the slot without searching every signal, and a
+ * handle whose slot is already gone is recognized as stale. A handle must
+ * not be used after its emitter has been destroyed.
+ */
+class Connection {
+public:
+    Connection() = default;
+
+    /**
+     * @brief True while the slot is still bound.
+     */
+    bool connected() const;
+
+    /**
+     * @brief Unbinds the slot if it is still bound, and resets the handle.
+     */
+    void disconnect();
+
+    /**
+     * @brief Returns the emitter the slot was bound to, nullptr for an empty handle.
+     */
+    ObjectSlots* owner() const { return owner_; }
+
+private:
+    friend class ObjectSlots;
+
+    Connection(ObjectSlots* owner, std::uint32_t index, std::uint32_t generation)
+        : owner_(owner), index_(index), generation_(generation) {}
+
+    ObjectSlots* owner_ = nullptr;
+    std::uint32_t index_ = 0;
+    std::uint32_t generation_ = 0;
+};
+
+/**
+ * @brief `ScopedConnection` disconnects its slot when it is destroyed.
+ *
+ * Example Usage:
+ * ```cpp
+ * ObjectSlots::ScopedConnection connection = emitter.bind(&MyEmitter::valueChanged, &globalFunctionSlot);
+ * ```
+ */
+class ScopedConnection {
+public:
+    ScopedConnection() = default;
+    ScopedConnection(Connection connection) : connection_(connection) {}
+    ~ScopedConnection() { connection_.disconnect(); }
+
+    ScopedConnection(const ScopedConnection&) = delete;
+    ScopedConnection& operator=(const ScopedConnection&) = delete;
+
+    ScopedConnection(ScopedConnection&& other) noexcept : connection_(other.release()) {}
+    ScopedConnection& operator=(ScopedConnection&& other) noexcept {
+        if( this != &other ) {
+            connection_.disconnect();
+            connection_ = other.release();
+        }
+        return *this;
+    }
+
+    const Connection& get() const { return connection_; }
+
+    /**
+     * @brief Gives up the ownership of the connection without disconnecting it.
+     */
+    Connection release() {
+        Connection connection = connection_;
+        connection_ = Connection();
+        return connection;
+    }
+
+private:
+    Connection connection_;
+};
+
+/**
+ * @brief `Transaction` stages the binds of one thread to an emitter and
+ *        stores them together, for wiring many slots at once.
+ *
+ * While it is open, `bind()` calls the opening thread makes on the emitter
+ * only reserve their connection, and unbinding a connection is recorded.
+ * Committing takes the write lock once, applies the unbinds, sizes every
+ * slot array for its new slots and merges them in, sorted by priority, in
+ * one pass per signal. A slot bound and unbound again in the same
+ * transaction never reaches a slot array. Handles work right away, and
+ * emits only see the staged slots once they are committed.
+ *
+ * Unbinding an object or a function takes effect at once, since it may be
+ * destroyed right after, and drops its staged binds as well. Transactions
+ * of the same thread nest, the outermost commits. Other threads opening one
+ * on the same emitter wait until it is committed, their other binds and
+ * unbinds are applied as usual.
+ *
+ * Example Usage:
+ * ```cpp
+ * {
+ *     ObjectSlots::Transaction wiring(emitter);
+ *     for( MyReceiver& receiver : receivers ) {
+ *         emitter.bind(&MyEmitter::valueChanged, &receiver, &MyReceiver::memberFunctionSlot);
+ *     }
+ * } // committed here
+ * ```
+ */
+class Transaction {
+public:
+    explicit Transaction(ObjectSlots& emitter);
+    ~Transaction() { commit(); }
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    /**
+     * @brief Commits the staged changes and closes the transaction, later
+     *        binds are applied at once. Does nothing if it is closed already.
+     *        A `std::bad_alloc` thrown by the destructor ends the program, call
+     *        it first where running out of memory is handled.
+     */
+    void commit();
+
+private:
+    ObjectSlots* emitter_;
+};
+
+/**
+ * @brief `Receiver` is a mixin for objects whose member functions are bound
+ *        as slots. It remembers every emitter it is bound to, so all of its
+ *        slots are unbound with one call, or when it is destroyed.
+ *
+ * Unbinding costs the number of the receiver's own connections, not the
+ * number of slots bound to its emitters. An emitter that is destroyed first
+ * removes itself from its receivers. A receiver and an emitter it is bound
+ * to must not be destroyed concurrently. With threaded emits, call
+ * `unbindAll()` in the derived destructor, so no slot runs on a partly
+ * destroyed object.
+ *
+ * Example Usage:
+ * ```cpp
+ * class MyReceiver : public ObjectSlots::Receiver {
+ * public:
+ *     void memberFunctionSlot(int value);
+ * };
+ * ```
+ */
+class Receiver {
+public:
+    /**
+     * @brief Unbinds the slots of this receiver from every emitter.
+     */
+    void unbindAll();
+
+protected:
+    Receiver() = default;
+    // A copy is a new receiver, it is not bound to anything.
+    Receiver(const Receiver&) : Receiver() {}
+    Receiver& operator=(const Receiver&) { return *this; }
+    ~Receiver() { unbindAll(); }
+
+private:
+    friend class ObjectSlots;
+
+    /**
+     * @brief An emitter and the object pointer the receiver's slots are bound with.
+     */
+    struct Link {
+        ObjectSlots* emitter;
+        const void* object;
+    };
+
+    void link(ObjectSlots* emitter, const void* object);
+    void forget(ObjectSlots* emitter);
+
+    std::vector<Link> links_;
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::mutex mutex_;
+#endif
+};
+
+/**
+ * @brief `Liveness` is the token a `Trackable` shares with its slots. It
+ *        tells whether the object still exists, and in threaded builds which
+ *        of its slots are running.
+ */
+class Liveness {
+public:
+    /**
+     * @brief Marks a call of a slot of the object for as long as it lives on the stack.
+     */
+    class Scope {
+    public:
+        explicit Scope(const Liveness& liveness) : liveness_(liveness) {
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+            entered_ = (liveness_.calls_.fetch_add(1, std::memory_order_acquire) & Expired) == 0;
+            if( !entered_ ) {
+                liveness_.calls_.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            outer_ = innermost_;
+            innermost_ = this;
+#else
+            entered_ = liveness_.alive_;
+#endif
+        }
+
+        ~Scope() {
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+            if( entered_ ) {
+                innermost_ = outer_;
+                liveness_.calls_.fetch_sub(1, std::memory_order_release);
+            }
+#endif
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @brief False if the object was gone, the slot must not be called then.
+         */
+        explicit operator bool() const { return entered_; }
+
+    private:
+        friend class Liveness;
+
+        const Liveness& liveness_;
+        bool entered_;
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+        const Scope* outer_ = nullptr;
+        /** @brief The scopes of the calling thread form a list, innermost first. */
+        static inline thread_local const Scope* innermost_ = nullptr;
+#endif
+    };
+
+    /**
+     * @brief True until `expire()` was called.
+     */
+    bool alive() const;
+
+    /**
+     * @brief Makes every later call of the object's slots a no-op. In threaded
+     *        builds it waits for the calls running on other threads to return.
+     */
+    void expire();
+
+private:
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+    static constexpr std::uint32_t Expired = 1u << 31;
+    /** @brief The running calls, and `Expired` once the object is gone. */
+    mutable std::atomic<std::uint32_t> calls_{0};
+#else
+    bool alive_ = true;
+#endif
+};
+
+/**
+ * @brief `Trackable` is a mixin for receivers whose slots must not outlive
+ *        them, without unbinding anything when they are destroyed.
+ *
+ * The slots of its member functions check a `Liveness` token the object
+ * shares with them before every call. Destroying the object only expires the
+ * token, whatever it is bound to. An emit that finds a slot of an expired
+ * object skips it and unbinds its connection, with the other binds and
+ * unbinds made during the emit, once it returns. Slots that return a value
+ * are bound as usual, they must be unbound before the object is destroyed.
+ *
+ * With threaded emits, call `expire()` first in the derived destructor. It
+ * waits for the object's slots running on other threads, so none of them
+ * sees a partly destroyed object.
+ *
+ * Example Usage:
+ * ```cpp
+ * class Display : public ObjectSlots::Trackable {
+ * public:
+ *     ~Display() { expire(); }
+ *     void onValueChanged(int value);
+ * };
+ * ```
+ */
+class Trackable {
+public:
+    /**
+     * @brief Returns the token the slots of this object check.
+     */
+    const std::shared_ptr<Liveness>& liveness() const { return liveness_; }
+
+protected:
+    Trackable() : liveness_(std::make_shared<Liveness>()) {}
+    // A copy is a new object, with a token of its own.
+    Trackable(const Trackable&) : Trackable() {}
+    Trackable& operator=(const Trackable&) { return *this; }
+    ~Trackable() { expire(); }
+
+    /**
+     * @brief Expires the token, see `Liveness::expire()`. Calling it again does nothing.
+     */
+    void expire() { liveness_->expire(); }
+
+private:
+    std::shared_ptr<Liveness> liveness_;
+};
+
+/**
+ * @brief `TrackedState` is shared by the copies of a tracked slot: the token
+ *        they check and the connection to drop once it expired.
+ */
+class TrackedState {
+public:
+    explicit TrackedState(std::shared_ptr<const Liveness> liveness) : liveness_(std::move(liveness)) {}
+
+    const Liveness& liveness() const { return *liveness_; }
+
+    void attach(ObjectSlots* owner, const Connection& connection);
+
+    /**
+     * @brief Unbinds the connection of an expired slot, the first time a call finds it expired.
+     */
+    void expired();
+
+private:
+    std::shared_ptr<const Liveness> liveness_;
+    std::mutex mutex_;
+    ObjectSlots* owner_ = nullptr;
+    Connection connection_;
+};
+
+/**
+ * @brief `SlotTracked` wraps the target of a slot of a `Trackable`. It only
+ *        invokes the target while the object lives.
+ * @tparam Target The slot of the object.
+ * @tparam Args The argument types of the signal.
+ */
+template<class Target, class ... Args>
+class SlotTracked {
+private:
+    Target target_;
+    std::shared_ptr<TrackedState> state_;
+
+public:
+    SlotTracked(const Target& target, std::shared_ptr<const Liveness> liveness)
+        : target_(target), state_(std::make_shared<TrackedState>(std::move(liveness))) {}
+
+    void operator()(SlotArg<Args>... args) const {
+        const Liveness::Scope call(state_->liveness());
+        if( call ) {
+            target_(args...);
+            return;
+        }
+        state_->expired();
+    }
+
+    /**
+     * @brief Lets calls that find the object expired unbind `connection`.
+     *        Without it they only skip the target.
+     */
+    void attach(ObjectSlots* owner, const Connection& connection) const {
+        state_->attach(owner, connection);
+    }
+
+    void disconnected() const {
+        if constexpr( Disconnectable<Target>::value ) {
+            target_.disconnected();
+        }
+    }
+};
+
+/**
+ * @brief `CoalescedState` is shared by a coalescing slot and the `Coalescer`
+ *        it is pending in. It keeps the latest arguments until the flush.
+ */
+template<class Target, class ... Args>
+class CoalescedState : public Coalescer::Pending {
+private:
+    Coalescer* coalescer_;
+    Target target_;
+    std::mutex mutex_;
+    std::optional<std::tuple<std::decay_t<Args>...>> latest_;
+    // Unbound slots are only destroyed once no emit can be running them,
+    // the emitter clears this as soon as it removes the connection.
+    bool connected_ = true;
+
+public:
+    CoalescedState(Coalescer* coalescer, const Target& target) : coalescer_(coalescer), target_(target) {}
+
+    /**
+     * @brief Drops the pending arguments, a later flush does not invoke the target.
+     */
+    void disconnected() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = false;
+        latest_.reset();
+    }
+
+    void update(SlotArg<Args>... args) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const bool scheduled = latest_.has_value();
+            latest_.emplace(args...);
+            if( scheduled ) {
+                return;
+            }
+        }
+        coalescer_->schedule(weak_from_this());
+    }
+
+    bool fire() override;
+};
+
+/**
+ * @brief `SlotCoalesced` wraps the target of a coalescing connection. Invoking
+ *        it only replaces the arguments the next flush of its `Coalescer` passes on.
+ * @tparam Target The slot invoked by the flush.
+ * @tparam Args The argument types of the signal.
+ */
+template<class Target, class ... Args>
+class SlotCoalesced {
+private:
+    std::shared_ptr<CoalescedState<Target, Args...>> state_;
+
+public:
+    SlotCoalesced(Coalescer* coalescer, const Target& target)
+        : state_(std::make_shared<CoalescedState<Target, Args...>>(coalescer, target)) {}
+
+    void operator()(SlotArg<Args>... args) const {
+        state_->update(args...);
+    }
+
+    void disconnected() const {
+        state_->disconnected();
+    }
+};
+
+/**
+ * @brief `Deferral` selects the slot wrapper of a connection that is not
+ *        invoked by `emit()`, by what it is deferred to.
+ */
+template<class Context>
+struct Deferral {
+    static constexpr bool value = false;
+};
+
+template<>
+struct Deferral<EventLoop> {
+    static constexpr bool value = true;
+    template<class Target, class ... Args>
+    using Slot = SlotQueued<Target, Args...>;
+};
+
+template<>
+struct Deferral<Coalescer> {
+    static constexpr bool value = true;
+    template<class Target, class ... Args>
+    using Slot = SlotCoalesced<Target, Args...>;
+};
+
+/**
+ * @brief `ObjectSlots` is a base class that provides signal/slot functionality.
+ *        Derived classes can emit signals, and other objects or functions can bind to these signals as slots.
+ *
+ * Example Usage:
+ * ```cpp
+ * #include <iostream>
+ * #include <slots/slots.hpp>
+ *
+ * class MyEmitter : public Slots::ObjectSlots {
+ * public:
+ *     void valueChanged(int newValue) {
+ *         emit(&MyEmitter::valueChanged, newValue);
+ *     }
+ * };
+ *
+ * void globalFunctionSlot(int value) {
+ *     std::cout << "Global function received: " << value << std::endl;
+ * }
+ *
+ * class MyReceiver {
+ * public:
+ *     void memberFunctionSlot(int value) {
+ *         std::cout << "Member function received: " << value << std::endl;
+ *     }
+ * };
+ *
+ * int main() {
+ *     MyEmitter emitter;
+ *     MyReceiver receiver;
+ *     emitter.bind(&MyEmitter::valueChanged, &globalFunctionSlot);
+ *     emitter.bind(&MyEmitter::valueChanged, &receiver, &MyReceiver::memberFunctionSlot);
+ *     emitter.valueChanged(42); // This will call both slots
+ *     return 0;
+ * }
+ * ```
+ */
+class ObjectSlots {
+public:
+    ObjectSlots();
+
+    /**
+     * @brief Creates an instance that allocates its slot storage from `resource`.
+     *        The default constructor uses `std::pmr::get_default_resource()`.
+     * @param resource The resource for slot arrays and heap allocated slots.
+     *                 It must outlive this instance, see `ConnectionPool`.
+     */
+    explicit ObjectSlots(std::pmr::memory_resource* resource);
+
+    /**
+     * @brief The number of independently locked shards the signals of an instance are spread over.
+     */
+    struct Shards {
+        std::size_t count;
+    };
+
+    /**
+     * @brief Creates an instance whose signals are spread over several shards, each
+     *        with a lock of its own on a cache line of its own. Binding or unbinding
+     *        a slot then only blocks emits of the signals in the same shard. Meant for
+     *        emitters with many independent signals used from different threads;
+     *        lock-free builds never block emits and ignore it.
+     * @param shards The number of shards, rounded up to a power of two, at most 32.
+     * @param resource The resource for slot arrays and heap allocated slots.
+     */
+    explicit ObjectSlots(Shards shards, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief How many signals and slots per signal an instance is sized for up front.
+     */
+    struct Capacity {
+        std::size_t signals;
+        std::size_t slotsPerSignal;
+    };
+
+    /**
+     * @brief Creates an instance whose tables are sized for `capacity` when it is
+     *        constructed, so binding up to that many slots never grows them. See
+     *        `StaticObjectSlots` for an instance that never allocates from the heap.
+     * @param capacity The signals and slots per signal to make room for.
+     * @param resource The resource for the tables, slot arrays and heap allocated slots.
+     */
+    explicit ObjectSlots(Capacity capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    virtual ~ObjectSlots();
+
+    /**
+     * @brief Returns the resource the slot storage is allocated from.
+     */
+    std::pmr::memory_resource* resource() const;
+
+    /**
+     * @brief Returns how many independently locked shards the signals are spread over.
+     */
+    std::size_t shardCount() const;
+
+    /**
+     * @brief The priority of a connection, given as the last argument of `bind()`.
+     *        The slots of a signal run from the highest priority to the lowest,
+     *        slots of equal priority in the order they were bound. Any value in
+     *        between the named ones may be used as well.
+     */
+    enum class Priority : std::int16_t {
+        Low = -100,
+        Normal = 0,
+        High = 100,
+        Urgent = 1000 ///< From here on, slots run on the urgent dispatcher if one is set.
+    };
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief Selects how `emit()` invokes the bound slots.
+     */
+    enum class EmitPolicy {
+        Inline, ///< Slots run one after the other on the emitting thread.
+        Wait,   ///< Slots run on the dispatcher, `emit()` returns once all of them finished.
+        Detach, ///< Slots run on the dispatcher, `emit()` returns once all of them are queued.
+        Parallel ///< Chunks of `grainSize()` slots run on the dispatcher and the emitting
+                 ///< thread, `emit()` returns once all of them finished.
+    };
+
+    /**
+     * @brief Sets the dispatcher used by this instance.
+     *        A new instance uses `Dispatcher::global()`.
+     * @param dispatcher The dispatcher to submit slot invocations to.
+     */
+    void setDispatcher(std::shared_ptr<Dispatcher> dispatcher);
+
+    /**
+     * @brief Returns the dispatcher used by this instance.
+     */
+    std::shared_ptr<Dispatcher> dispatcher() const;
+
+    /**
+     * @brief Sets a separate dispatcher for slots bound with `Priority::Urgent` or
+     *        above, so they never queue behind slow slots. Without one they use
+     *        the regular dispatcher.
+     * @param dispatcher The dispatcher for urgent slots, or nullptr.
+     */
+    void setUrgentDispatcher(std::shared_ptr<Dispatcher> dispatcher);
+
+    /**
+     * @brief Returns the dispatcher for urgent slots, or nullptr.
+     */
+    std::shared_ptr<Dispatcher> urgentDispatcher() const;
+
+    /**
+     * @brief Sets how `emit()` invokes the bound slots, `EmitPolicy::Wait` by default.
+     * @param policy The policy to use for every following emit.
+     */
+    void setEmitPolicy(EmitPolicy policy);
+
+    /**
+     * @brief Returns how `emit()` invokes the bound slots.
+     */
+    EmitPolicy emitPolicy() const;
+
+    /**
+     * @brief Sets how many slots one task runs with `EmitPolicy::Parallel`, 64 by default.
+     *        A signal with no more slots than this runs on the emitting thread alone.
+     * @param grain The number of slots per task, zero is treated as one.
+     */
+    void setGrainSize(std::size_t grain);
+
+    /**
+     * @brief Returns how many slots one task runs with `EmitPolicy::Parallel`.
+     */
+    std::size_t grainSize() const;
+#endif
+
+    template<class SignalType, class ReturnType, typename Func, class ... Args>
+    Connection bind(
+        SlotMethodP<SignalType, ReturnType, Args...> signal,
+        //T* object,
+        Func&& f,
+        Priority priority = Priority::Normal)
+    {
+        union {
+            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindCallable<ReturnType, Args...>(to_void_ptr.ptr, std::forward<Func>(f), priority);
+    }
+
+    /**
+     * @brief Unbinds every slot bound with the callable variable `f`.
+     *        A callable bound as a temporary is unbound through its `Connection`.
+     */
+    template<typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, Connection>>>
+    void unbind(Func&& f) {
+        static_assert(std::is_lvalue_reference_v<Func>,
+            "a callable is identified by the variable passed to bind(), a temporary matches no slot");
+        slotRemove(nullptr, const_cast<void*>(static_cast<const void*>(std::addressof(f))));
+    }
+
+    /**
+     * @brief Binds a member function slot to a signal.
+     *
+     * @tparam SignalType The class type of the object emitting the signal.
+     * @tparam ReturnType The return type of the signal and slot.
+     * @tparam T The class type of the object owning the slot method.
+     * @tparam Args The argument types of the signal.
+     * @tparam SlotArgs The argument types of the slot, e.g. `const T&` for a signal argument `T`.
+     * @param signal A pointer to the member function representing the signal.
+     * @param object A pointer to the object instance that owns the slot method.
+     * @param callback A pointer to the member function representing the slot.
+     * @param priority Where the slot runs among the others of the signal.
+     */
+    template <class SignalType, class ReturnType, class T, class ... Args, class ... SlotArgs>
+    Connection bind(
+        SlotMethodP<SignalType, ReturnType, Args...> signal,
+        T* object,
+        SlotMethodP<T, ReturnType, SlotArgs...> callback,
+        Priority priority = Priority::Normal)
+    {
+        union {
+            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindMethod<ReturnType, Args...>(to_void_ptr.ptr, object, callback, priority);
+    }
+
+    /**
+     * @brief Binds a free function slot to a signal.
+     *
+     * @tparam SignalType The class type of the object emitting the signal.
+     * @tparam ReturnType The return type of the signal and slot.
+     * @tparam Args The argument types of the signal.
+     * @tparam SlotArgs The argument types of the slot, e.g. `const T&` for a signal argument `T`.
+     * @param signal A pointer to the member function representing the signal.
+     * @param callback A pointer to the free function representing the slot.
+     * @param priority Where the slot runs among the others of the signal.
+     */
+    template <class SignalType, class ReturnType, class ... Args, class ... SlotArgs>
+    Connection bind(
+        SlotMethodP<SignalType, ReturnType, Args...> signal,
+        SlotFunctionP<ReturnType, SlotArgs...> callback,
+        Priority priority = Priority::Normal)
+    {
+        union {
+            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindFunction<ReturnType, Args...>(to_void_ptr.ptr, callback, priority);
+    }
+
+    /**
+     * @brief Binds a callable as a deferred slot, which `emit()` does not invoke.
+     *
+     * With an `EventLoop` the slot is queued: each emit copies the arguments
+     * into an event, and the callable is shared by all events and stays alive
+     * until the last of them has run. With a `Coalescer` the slot coalesces:
+     * each emit replaces the arguments the next flush invokes it with.
+     *
+     * @param context The `EventLoop` or `Coalescer` that invokes the slot, it must outlive the connection.
+     */
+    template<class SignalType, class ReturnType, typename Func, class Context, class ... Args>
+    std::enable_if_t<Deferral<Context>::value, Connection> bind(
+        SlotMethodP<SignalType, ReturnType, Args...> signal,
+        Func&& f,
+        Context& context)
+    {
+        union {
+            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindDeferredCallable<ReturnType, Args...>(to_void_ptr.ptr, std::forward<Func>(f), context);
+    }
+
+    /**
+     * @brief Binds a member function as a deferred slot, invoked by an `EventLoop`
+     *        on the thread that processes it, or by the flush of a `Coalescer`.
+     *        `object` must outlive the events posted for it.
+     * @param context The `EventLoop` or `Coalescer` that invokes the slot, it must outlive the connection.
+     */
+    template <class SignalType, class ReturnType, class T, class Context, class ... Args, class ... SlotArgs>
+    std::enable_if_t<Deferral<Context>::value, Connection> bind(
+        SlotMethodP<SignalType, ReturnType, Args...> signal,
+        T* object,
+        SlotMethodP<T, ReturnType, SlotArgs...> callback,
+        Context& context)
+    {
+        union {
+            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindDeferredMethod<ReturnType, Args...>(to_void_ptr.ptr, object, callback, context);
+    }
+
+    /**
+     * @brief Binds a free function as a deferred slot, invoked by an `EventLoop`
+     *        on the thread that processes it, or by the flush of a `Coalescer`.
+     * @param context The `EventLoop` or `Coalescer` that invokes the slot, it must outlive the connection.
+     */
+    template <class SignalType, class ReturnType, class Context, class ... Args, class ... SlotArgs>
+    std::enable_if_t<Deferral<Context>::value, Connection> bind(
+        SlotMethodP<SignalType, ReturnType, Args...> signal,
+        SlotFunctionP<ReturnType, SlotArgs...> callback,
+        Context& context)
+    {
+        union {
+            SlotMethodP<SignalType, ReturnType, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindDeferredFunction<ReturnType, Args...>(to_void_ptr.ptr, callback, context);
+    }
+
+    /**
+     * @brief Binds a batch-aware member function, which receives a whole
+     *        `emitBatch()` at once. A single emit reaches it as a batch of one.
+     *
+     * @param signal A pointer to the member function representing the signal.
+     * @param object A pointer to the object instance that owns the slot method.
+     * @param callback A method taking a `const Batch<Args...>&`.
+     */
+    template <class SignalType, class T, class ... Args, class ... SlotArgs>
+    Connection bindBatch(
+        SlotMethodP<SignalType, void, Args...> signal,
+        T* object,
+        SlotMethodP<T, void, SlotArgs...> callback)
+    {
+        union {
+            SlotMethodP<SignalType, void, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindBatchMethod<Args...>(to_void_ptr.ptr, object, callback);
+    }
+
+    /**
+     * @brief Binds a batch-aware free function, which receives a whole `emitBatch()` at once.
+     * @param callback A function taking a `const Batch<Args...>&`.
+     */
+    template <class SignalType, class ... Args, class ... SlotArgs>
+    Connection bindBatch(
+        SlotMethodP<SignalType, void, Args...> signal,
+        SlotFunctionP<void, SlotArgs...> callback)
+    {
+        union {
+            SlotMethodP<SignalType, void, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return bindBatchFunction<Args...>(to_void_ptr.ptr, callback);
+    }
+
+    /**
+     * @brief Unbinds a member function slot from all signals it might be connected to.
+     *
+     * @tparam T The class type of the object owning the slot method.
+     * @tparam ReturnType The return type of the slot.
+     * @tparam Args The argument types of the slot.
+     * @param object A pointer to the object instance that owns the slot method.
+     * @param method A pointer to the member function representing the slot.
+     *               This method will be unbound from any signal it's connected to on this ObjectSlots.
+     */
+    template <class T, class ReturnType, class ... Args>
+    void unbind(T* object, SlotMethodP<T, ReturnType, Args...> method) {
+        union {
+            SlotMethodP<T, ReturnType, Args...> method_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.method_ptr = method;
+        slotRemove(object, to_void_ptr.ptr);
+    }
+
+    /**
+     * @brief Unbinds a free function slot from all signals it might be connected to.
+     *
+     * @tparam ReturnType The return type of the slot.
+     * @tparam Args The argument types of the slot.
+     * @param function A pointer to the free function representing the slot.
+     *                 This function will be unbound from any signal it's connected to on this ObjectSlots.
+     *                 Note: This unbinds the specific function, not all functions.
+     */
+    template <class ReturnType, class ... Args>
+    void unbind(SlotFunctionP<ReturnType, Args...> function) {
+        union {
+            SlotFunctionP<ReturnType, Args...> function_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.function_ptr = function;
+        slotRemove(nullptr, to_void_ptr.ptr);
+    }
+
+    /**
+     * @brief Unbinds all slots associated with a specific object.
+     *
+     * @tparam T The class type of the object.
+     * @param object A pointer to the object whose member function slots should be unbound.
+     *               All member function slots belonging to this object that are bound to any signal
+     *               on this ObjectSlots will be removed.
+     */
+    template <class T>
+    void unbind(T* object) {
+        slotRemove(object, nullptr);
+    }
+
+    /**
+     * @brief Unbinds a specific free function slot from all signals it might be connected to.
+     * @param function A void pointer to the free function to be unbound.
+     */
+    void unbind(void* function) {
+        slotRemove(nullptr, function);
+    }
+
+    /**
+     * @brief Unbinds the slot a connection refers to, in constant time.
+     *        Stale handles and handles of other emitters are ignored.
+     * @param connection The handle returned by `bind()`.
+     */
+    void unbind(const Connection& connection);
+
+    /**
+     * @brief Returns true while the slot a connection refers to is bound to this instance.
+     */
+    bool connected(const Connection& connection) const;
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief Sets the worker group of the dispatcher that runs the slot a
+     *        connection refers to, whenever an emit hands it to the dispatcher.
+     *        Inline emits run it on the emitting thread all the same.
+     * @param connection The handle returned by `bind()`.
+     * @param group The index of a `WorkerGroup`, `Dispatcher::CallerGroup` for
+     *              the group of the emitting thread's CPU, or `Dispatcher::AnyGroup`.
+     *              Indices past the groups of the dispatcher mean any worker.
+     * @return False for stale handles and handles of other emitters.
+     */
+    bool setAffinity(const Connection& connection, std::size_t group);
+#endif
+
+#ifdef OBJECTSLOTS_STATS
+    /**
+     * @brief Returns what was recorded for every signal that has a slot list,
+     *        and for the slots bound to it right now.
+     *
+     * Counters are updated with relaxed atomics while emits run, so a
+     * snapshot taken meanwhile is consistent per counter, not as a whole.
+     */
+    std::vector<SignalStats> stats() const;
+
+    /**
+     * @brief Sets every counter and histogram back to zero.
+     */
+    void resetStats();
+
+    /**
+     * @brief Returns the identifier `stats()` reports for a signal emitted with `emit()`.
+     *        A typed `Signal` is reported by its address.
+     */
+    template<class T, class ... Args>
+    static const void* signalId(SlotMethodP<T, void, Args...> signal) {
+        union {
+            SlotMethodP<T, void, Args...> signal_ptr;
+            const void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = signal;
+        return to_void_ptr.ptr;
+    }
+#endif
+
+protected:
+    /**
+     * @brief Emits a signal, invoking all bound slots.
+     *
+     * This method is intended to be called by derived classes to trigger a signal.
+     * It iterates through all slots bound to the given signal and invokes them with the provided arguments.
+     *
+     * The arguments are forwarded, every slot sees the same objects through
+     * a const reference. An argument of a different type is converted once.
+     * Detached emits share a single copy of the arguments.
+     *
+     * @tparam T The class type of the object emitting the signal.
+     * @tparam Args The argument types of the signal and the slots.
+     * @param callback A pointer to the member function representing the signal being emitted.
+     * @param args The arguments to pass to the bound slots.
+     */
+    template<class T, class ... Args, class ... Params>
+    void emit(
+        SlotMethodP<T, void, Args...> callback,
+        Params&& ... args)
+    {
+        static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of signal arguments");
+        union {
+            SlotMethodP<T, void, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = callback;
+        ReadLock lock(this, to_void_ptr.ptr);
+        dispatch<Args...>(getSlots(to_void_ptr.ptr), static_cast<SlotArg<Args>>(std::forward<Params>(args))...);
+    }
+
+    /**
+     * @brief Emits a signal once per element of a batch.
+     *
+     * The signal is looked up and the lock taken once for the whole batch,
+     * and each slot runs over every element before the next slot starts, so
+     * its code and data stay in cache. Batch-aware slots receive the batch
+     * in a single call. The emit policy applies to the batch as a whole.
+     * The arguments of the signal must be values or const references.
+     *
+     * @param callback A pointer to the member function representing the signal being emitted.
+     * @param batch A `Batch<Args...>`, or a contiguous container of `std::tuple<Args...>`.
+     */
+    template<class T, class ... Args, class Range>
+    void emitBatch(
+        SlotMethodP<T, void, Args...> callback,
+        const Range& batch)
+    {
+        union {
+            SlotMethodP<T, void, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = callback;
+        const Batch<Args...> view(batch);
+        if( view.empty() ) {
+            return;
+        }
+        ReadLock lock(this, to_void_ptr.ptr);
+        dispatchBatch<Args...>(getSlots(to_void_ptr.ptr), view);
+    }
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief Emits a signal without waiting for the slots, whatever the emit policy.
+     *
+     * The invocations are queued on the dispatcher with a copy of the
+     * arguments, like for `EmitPolicy::Detach`, and the call returns at once.
+     *
+     * @return A token that completes once every slot has finished. It may be dropped.
+     */
+    template<class T, class ... Args, class ... Params>
+    Completion emitAsync(
+        SlotMethodP<T, void, Args...> callback,
+        Params&& ... args)
+    {
+        static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of signal arguments");
+        union {
+            SlotMethodP<T, void, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = callback;
+        ReadLock lock(this, to_void_ptr.ptr);
+        EmitPolicy policy;
+        const Lanes lanes = currentDispatcher(policy);
+        const SlotSpan slots = getSlots(to_void_ptr.ptr);
+        OBJECTSLOTS_TRACE_SCOPE("emit", slots.signal);
+        countEmit(slots, 1);
+        return detach<Args...>(lanes, slots, true, static_cast<SlotArg<Args>>(std::forward<Params>(args))...);
+    }
+#endif
+
+    /**
+     * @brief Emits a signal whose slots return a value, and folds the results with a combiner.
+     *
+     * The slots run in priority order and hand their results to the combiner
+     * one by one, see `Combiners.hpp`. With `EmitPolicy::Inline`, and for
+     * combiners that declare `shortCircuits`, they run on the emitting thread
+     * and no slot runs after the combiner declined further results. Otherwise
+     * they run in waves of `grainSize()` slots on the dispatcher; a wave always
+     * runs to its end, the results are added in slot order and only the waves
+     * after a declined result are skipped. The results of a wave are kept in
+     * one buffer, the call returns once they are combined whatever the policy.
+     *
+     * Example Usage:
+     * ```cpp
+     * int signal_cost(int load) {
+     *     return collect(&MyEmitter::signal_cost, ObjectSlots::Sum<int>(), load);
+     * }
+     * ```
+     *
+     * @param callback A pointer to the member function representing the signal being emitted.
+     * @param combiner The combiner, e.g. `Sum<R>`, `First<R>` or `AllOf`.
+     * @param args The arguments to pass to the bound slots.
+     * @return What `combiner.result()` returns.
+     */
+    template<class T, class R, class ... Args, class Combiner, class ... Params>
+    auto collect(
+        SlotMethodP<T, R, Args...> callback,
+        Combiner combiner,
+        Params&& ... args) -> decltype(combiner.result())
+    {
+        static_assert(!std::is_void_v<R>, "a signal without a return value is emitted with emit()");
+        static_assert(!std::is_reference_v<R>, "slots of a collected signal must return a value");
+        static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of signal arguments");
+        union {
+            SlotMethodP<T, R, Args...> signal_ptr;
+            void *ptr;
+        } to_void_ptr;
+        to_void_ptr.signal_ptr = callback;
+        {
+            ReadLock lock(this, to_void_ptr.ptr);
+            gather<R, Args...>(getSlots(to_void_ptr.ptr), combiner, static_cast<SlotArg<Args>>(std::forward<Params>(args))...);
+        }
+        return combiner.result();
+    }
+private:
+    template<class ... Args>
+    friend class Signal;
+
+    struct impl;
+    impl* impl_;
+    struct Channel;
+
+    /**
+     * @brief The emit plan of one signal: its bound slots in the order they run,
+     *        without the ones unbound since, valid while the lock is held.
+     */
+    struct SlotSpan {
+        const SlotStorage* data;
+        std::size_t size;
+        /** @brief The number of slots of at least `Priority::Urgent`, they come first. */
+        std::size_t urgentSlots;
+        const void* signal;
+#ifdef OBJECTSLOTS_STATS
+        const Channel* channel;
+#endif
+
+        const SlotStorage* begin() const { return data; }
+        const SlotStorage* end() const { return data + size; }
+    };
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief The dispatchers of one emit, urgent slots go to `urgent` if there is one.
+     */
+    struct Lanes {
+        Dispatcher* regular;
+        Dispatcher* urgent;
+
+        /**
+         * @brief Returns the dispatcher of slot `i` of an emit plan.
+         */
+        Dispatcher* operator()(const SlotSpan& slots, std::size_t i) const {
+            return urgent && i < slots.urgentSlots ? urgent : regular;
+        }
+
+        /**
+         * @brief Submits a task of slot `i` of an emit plan to its dispatcher,
+         *        for the workers of its affinity.
+         */
+        void submit(const SlotSpan& slots, std::size_t i, Dispatcher::Task task, TaskGroup* group) const {
+            (*this)(slots, i)->submit(std::move(task), group, workers(slots.data[i]));
+        }
+
+        /**
+         * @brief Returns the worker group argument of `Dispatcher::submit()` for a slot.
+         */
+        static std::size_t workers(const SlotStorage& slot) {
+            switch( slot.affinity() ) {
+            case SlotStorage::AnyWorkers:
+                return Dispatcher::AnyGroup;
+            case SlotStorage::CallerWorkers:
+                return Dispatcher::CallerGroup;
+            default:
+                return slot.affinity();
+            }
+        }
+    };
+#endif
+
+    /**
+     * @brief Stores a slot inline if it fits and can be called through a
+     *        const reference, otherwise on the heap.
+     */
+    template<class ReturnType, class ... Args, class Callable>
+    Connection storeCallable(void* signal, Callable&& callable, const void* object, const void* callback,
+        Priority priority = Priority::Normal) {
+        using F = std::decay_t<Callable>;
+        static_assert(std::is_invocable_r_v<ReturnType, F&, SlotArg<Args>...>,
+            "the slot cannot be called with the arguments of the signal");
+        // A callable that mutates itself must not be copied into
+        // every snapshot of the slot list, it stays on the heap.
+        if constexpr( SlotStorage::fitsInline<F> && std::is_invocable_r_v<ReturnType, const F&, SlotArg<Args>...> ) {
+            return slotStore(signal, SlotStorage::makeInline<ReturnType, Args...>(callable, object, callback), priority);
+        } else {
+            using Lambda = SlotCallable<F, ReturnType, Args...>;
+            std::pmr::memory_resource* memory = resource();
+            void* allocation = memory->allocate(sizeof(Lambda), alignof(Lambda));
+            Lambda* lambda;
+            try {
+                lambda = ::new (allocation) Lambda(std::forward<Callable>(callable), callback);
+            } catch( ... ) {
+                memory->deallocate(allocation, sizeof(Lambda), alignof(Lambda));
+                throw;
+            }
+            return slotStore(signal, SlotStorage::makeHeap<ReturnType, Args...>(lambda, memory, object, callback), priority);
+        }
+    }
+
+    /**
+     * @brief The identity of a bound callable for `unbind(f)`: the address of
+     *        the variable passed to `bind()`. A temporary has none, it is
+     *        unbound through its `Connection`.
+     */
+    template<class Func>
+    static const void* callableId(Func& f) {
+        if constexpr( std::is_lvalue_reference_v<Func> ) {
+            return std::addressof(f);
+        } else {
+            static_cast<void>(f);
+            return nullptr;
+        }
+    }
+
+    template<class ReturnType, class ... Args, class Func>
+    Connection bindCallable(void* signal, Func&& f, Priority priority) {
+        const void* id = callableId<Func>(f);
+        return storeCallable<ReturnType, Args...>(signal, std::forward<Func>(f), nullptr, id, priority);
+    }
+
+    template<class ReturnType, class ... Args, class Func, class Context>
+    Connection bindDeferredCallable(void* signal, Func&& f, Context& context) {
+        using Callable = std::decay_t<Func>;
+        static_assert(std::is_void_v<ReturnType>, "a deferred slot cannot return a value");
+        static_assert(std::is_invocable_v<Callable&, std::decay_t<Args>&...>,
+            "the slot cannot be called with the arguments of the signal");
+        const void* id = callableId<Func>(f);
+        auto shared = std::make_shared<Callable>(std::forward<Func>(f));
+        auto target = [shared](auto& ... args) { (*shared)(args...); };
+        using Slot = typename Deferral<Context>::template Slot<decltype(target), Args...>;
+        const Slot slot(&context, target);
+        return storeCallable<ReturnType, Args...>(signal, slot, nullptr, id);
+    }
+
+    template<class ReturnType, class ... Args, class T, class ... SlotArgs>
+    Connection bindMethod(void* signal, T* object, SlotMethodP<T, ReturnType, SlotArgs...> callback, Priority priority) {
+        static_assert(std::is_invocable_r_v<ReturnType, SlotMethodP<T, ReturnType, SlotArgs...>, T*, SlotArg<Args>...>,
+            "the slot cannot be called with the arguments of the signal");
+        using Method = SlotMethod<T, ReturnType, SlotArgs...>;
+        Method method(object, callback);
+        Connection connection;
+        if constexpr( std::is_base_of_v<Trackable, T> && std::is_void_v<ReturnType> ) {
+            const SlotTracked<Method, Args...> tracked(method, object->liveness());
+            connection = storeCallable<ReturnType, Args...>(signal, tracked, method.object(), method.callback(), priority);
+            tracked.attach(this, connection);
+        } else {
+            connection = slotStore(signal, SlotStorage::makeInline<ReturnType, Args...>(method, method.object(), method.callback()), priority);
+        }
+        if constexpr( std::is_base_of_v<Receiver, T> ) {
+            track(object, method.object());
+        }
+        return connection;
+    }
+
+    template<class ReturnType, class ... Args, class T, class ... SlotArgs, class Context>
+    Connection bindDeferredMethod(void* signal, T* object, SlotMethodP<T, ReturnType, SlotArgs...> callback, Context& context) {
+        static_assert(std::is_void_v<ReturnType>, "a deferred slot cannot return a value");
+        static_assert(std::is_invocable_v<SlotMethodP<T, ReturnType, SlotArgs...>, T*, SlotArg<Args>...>,
+            "the slot cannot be called with the arguments of the signal");
+        using Method = SlotMethod<T, ReturnType, SlotArgs...>;
+        Method method(object, callback);
+        Connection connection;
+        if constexpr( std::is_base_of_v<Trackable, T> ) {
+            // Checked when the call is deferred, which unbinds an expired
+            // slot, and again when it runs, which only skips it.
+            using Slot = typename Deferral<Context>::template Slot<SlotTracked<Method, Args...>, Args...>;
+            const Slot slot(&context, SlotTracked<Method, Args...>(method, object->liveness()));
+            const SlotTracked<Slot, Args...> tracked(slot, object->liveness());
+            connection = storeCallable<ReturnType, Args...>(signal, tracked, method.object(), method.callback());
+            tracked.attach(this, connection);
+        } else {
+            using Slot = typename Deferral<Context>::template Slot<Method, Args...>;
+            const Slot slot(&context, method);
+            connection = storeCallable<ReturnType, Args...>(signal, slot, method.object(), method.callback());
+        }
+        if constexpr( std::is_base_of_v<Receiver, T> ) {
+            track(object, method.object());
+        }
+        return connection;
+    }
+
+    template<class ReturnType, class ... Args, class ... SlotArgs>
+    Connection bindFunction(void* signal, SlotFunctionP<ReturnType, SlotArgs...> callback, Priority priority) {
+        static_assert(std::is_invocable_r_v<ReturnType, SlotFunctionP<ReturnType, SlotArgs...>, SlotArg<Args>...>,
+            "the slot cannot be called with the arguments of the signal");
+        SlotFunction<ReturnType, SlotArgs...> function(callback);
+        return slotStore(signal, SlotStorage::makeInline<ReturnType, Args...>(function, function.object(), function.callback()), priority);
+    }
+
+    template<class ReturnType, class ... Args, class ... SlotArgs, class Context>
+    Connection bindDeferredFunction(void* signal, SlotFunctionP<ReturnType, SlotArgs...> callback, Context& context) {
+        static_assert(std::is_void_v<ReturnType>, "a deferred slot cannot return a value");
+        static_assert(std::is_invocable_v<SlotFunctionP<ReturnType, SlotArgs...>, SlotArg<Args>...>,
+            "the slot cannot be called with the arguments of the signal");
+        using Function = SlotFunction<ReturnType, SlotArgs...>;
+        Function function(callback);
+        using Slot = typename Deferral<Context>::template Slot<Function, Args...>;
+        const Slot slot(&context, function);
+        return storeCallable<ReturnType, Args...>(signal, slot, function.object(), function.callback());
+    }
+
+    template<class ... Args, class Target>
+    Connection storeBatch(void* signal, const Target& target) {
+        using Heap = SlotBatch<Target, Args...>;
+        std::pmr::memory_resource* memory = resource();
+        void* allocation = memory->allocate(sizeof(Heap), alignof(Heap));
+        Heap* heap;
+        try {
+            heap = ::new (allocation) Heap(target);
+        } catch( ... ) {
+            memory->deallocate(allocation, sizeof(Heap), alignof(Heap));
+            throw;
+        }
+        return slotStore(signal, SlotStorage::makeBatch<Args...>(heap, memory, target.object(), target.callback()));
+    }
+
+    template<class ... Args, class T, class ... SlotArgs>
+    Connection bindBatchMethod(void* signal, T* object, SlotMethodP<T, void, SlotArgs...> callback) {
+        static_assert(std::is_invocable_v<SlotMethodP<T, void, SlotArgs...>, T*, const Batch<Args...>&>,
+            "a batch slot must take a const Batch<Args...>& of the signal's arguments");
+        Connection connection = storeBatch<Args...>(signal, SlotMethod<T, void, SlotArgs...>(object, callback));
+        if constexpr( std::is_base_of_v<Receiver, T> ) {
+            track(object, object);
+        }
+        return connection;
+    }
+
+    template<class ... Args, class ... SlotArgs>
+    Connection bindBatchFunction(void* signal, SlotFunctionP<void, SlotArgs...> callback) {
+        static_assert(std::is_invocable_v<SlotFunctionP<void, SlotArgs...>, const Batch<Args...>&>,
+            "a batch slot must take a const Batch<Args...>& of the signal's arguments");
+        return storeBatch<Args...>(signal, SlotFunction<void, SlotArgs...>(callback));
+    }
+
+    /**
+     * @brief Emits to the slots of a `Signal`, which refers to its channel directly.
+     */
+    template<class ... Args>
+    void emitChannel(const void* signal, const Channel* channel, SlotArg<Args>... args) {
+        ReadLock lock(this, signal);
+        dispatch<Args...>(channelSlots(channel), args...);
+    }
+
+    /**
+     * @brief Invokes the slots of one signal according to the emit policy.
+     *        The caller must hold the read lock.
+     */
+    template<class ... Args>
+    void dispatch(const SlotSpan slots, SlotArg<Args>... args) {
+        OBJECTSLOTS_TRACE_SCOPE("emit", slots.signal);
+        countEmit(slots, 1);
+#ifdef OBJECTSLOTS_THREADED
+        EmitPolicy policy;
+        const Lanes lanes = currentDispatcher(policy);
+        if( policy == EmitPolicy::Detach ) {
+            detach<Args...>(lanes, slots, false, args...);
+            return;
+        }
+        if( policy == EmitPolicy::Parallel ) {
+            fanOut(lanes, slots, [this, &args...](const SlotStorage& slot) {
+                measure(slot, 1, [&slot, &args...]() { slot.invoke<void, Args...>(args...); });
+            });
+            return;
+        }
+        if( policy == EmitPolicy::Wait ) {
+            TaskGroup group;
+            std::tuple<SlotArg<Args>...> params(args...);
+            TaskWait pending(*lanes.regular, group);
+            for( std::size_t i = 0; i < slots.size; ++i ) {
+                const SlotStorage* target = &slots.data[i];
+                lanes.submit(slots, i, [this, target, &params]() {
+                    DispatchScope scope(this);
+                    measure(*target, 1, [target, &params]() { target->apply<void, Args...>(params); });
+                }, &group);
+            }
+            // Slots must not be removed while they are still running,
+            // so the lock is only released after the wait.
+            OBJECTSLOTS_TRACE_SCOPE("wait", slots.signal);
+            pending.wait();
+            return;
+        }
+#endif
+        for( const SlotStorage& slot : slots ) {
+            measure(slot, 1, [&slot, &args...]() { slot.invoke<void, Args...>(args...); });
+        }
+    }
+
+    template<class ... Args>
+    void emitChannelBatch(const void* signal, const Channel* channel, const Batch<Args...>& batch) {
+        if( batch.empty() ) {
+            return;
+        }
+        ReadLock lock(this, signal);
+        dispatchBatch<Args...>(channelSlots(channel), batch);
+    }
+
+    /**
+     * @brief Runs every slot of one signal over a batch according to the emit policy.
+     *        The caller must hold the read lock.
+     */
+    template<class ... Args>
+    void dispatchBatch(const SlotSpan slots, const Batch<Args...>& batch) {
+        static_assert(std::conjunction_v<std::is_convertible<const std::decay_t<Args>&, SlotArg<Args>>...>,
+            "a batch can only be emitted to arguments taken by value or by const reference");
+        OBJECTSLOTS_TRACE_SCOPE("emit", slots.signal);
+        countEmit(slots, batch.size());
+#ifdef OBJECTSLOTS_THREADED
+        EmitPolicy policy;
+        const Lanes lanes = currentDispatcher(policy);
+        if( policy == EmitPolicy::Detach ) {
+            if( slots.size == 0 ) {
+                return;
+            }
+            using Elements = std::vector<typename Batch<Args...>::Element>;
+            auto detached = new DetachedEmit<Elements>(slots.data, slots.size, batch.begin(), batch.end());
+            for( std::size_t i = 0; i < slots.size; ++i ) {
+                lanes.submit(slots, i, [this, detached, i]() {
+                    const SlotStorage& slot = detached->slots[i];
+                    measure(slot, detached->args.size(), [&slot, detached]() {
+                        slot.template invokeBatch<Args...>(Batch<Args...>(detached->args));
+                    });
+                    detached->release();
+                }, &detachedTasks());
+            }
+            return;
+        }
+        if( policy == EmitPolicy::Parallel ) {
+            fanOut(lanes, slots, [this, &batch](const SlotStorage& slot) {
+                measure(slot, batch.size(), [&slot, &batch]() { slot.invokeBatch<Args...>(batch); });
+            });
+            return;
+        }
+        if( policy == EmitPolicy::Wait ) {
+            TaskGroup group;
+            TaskWait pending(*lanes.regular, group);
+            for( std::size_t i = 0; i < slots.size; ++i ) {
+                const SlotStorage* target = &slots.data[i];
+                lanes.submit(slots, i, [this, target, &batch]() {
+                    DispatchScope scope(this);
+                    measure(*target, batch.size(), [target, &batch]() { target->invokeBatch<Args...>(batch); });
+                }, &group);
+            }
+            OBJECTSLOTS_TRACE_SCOPE("wait", slots.signal);
+            pending.wait();
+            return;
+        }
+#endif
+        for( const SlotStorage& slot : slots ) {
+            measure(slot, batch.size(), [&slot, &batch]() { slot.invokeBatch<Args...>(batch); });
+        }
+    }
+
+    /**
+     * @brief Invokes the slots of one signal in order and adds their results to
+     *        `combiner` until it stops. The caller must hold the read lock.
+     */
+    template<class R, class ... Args, class Combiner>
+    void gather(const SlotSpan slots, Combiner& combiner, SlotArg<Args>... args) {
+        OBJECTSLOTS_TRACE_SCOPE("emit", slots.signal);
+        countEmit(slots, 1);
+#ifdef OBJECTSLOTS_THREADED
+        EmitPolicy policy;
+        const Lanes lanes = currentDispatcher(policy);
+        // Short-circuiting combiners must not see slots run past the one that stops them.
+        if( policy != EmitPolicy::Inline && !ShortCircuits<Combiner>::value ) {
+            gatherWaves<R, Args...>(lanes, slots, combiner, args...);
+            return;
+        }
+#endif
+        std::optional<R> result;
+        for( const SlotStorage& slot : slots ) {
+            measure(slot, 1, [&slot, &result, &args...]() { result.emplace(slot.invoke<R, Args...>(args...)); });
+            if( !combiner.add(std::move(*result)) ) {
+                return;
+            }
+            result.reset();
+        }
+    }
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief Runs the slots of one signal on the dispatcher in waves of up to
+     *        `grainSize()`, each into its own cell of a buffer, and adds the
+     *        results of a wave in slot order before the next one starts.
+     *        The caller must hold the read lock.
+     */
+    template<class R, class ... Args, class Combiner>
+    void gatherWaves(const Lanes& lanes, const SlotSpan slots, Combiner& combiner, SlotArg<Args>... args) {
+        if( slots.size == 0 ) {
+            return;
+        }
+        using Results = std::pmr::vector<std::optional<R>>;
+        Results results(std::min(grainSize(), slots.size), typename Results::allocator_type(resource()));
+        std::tuple<SlotArg<Args>...> params(args...);
+        for( std::size_t next = 0; next < slots.size; ) {
+            TaskGroup group;
+            TaskWait pending(*lanes.regular, group);
+            const SlotStorage* own = nullptr;
+            std::optional<R>* ownResult = nullptr;
+            bool queued = false;
+            std::size_t count = 0;
+            for( ; next < slots.size && count < results.size(); ++next ) {
+                const SlotStorage* slot = &slots.data[next];
+                std::optional<R>* result = &results[count++];
+                // The emitting thread runs one regular slot of the wave itself.
+                if( !own && lanes(slots, next) == lanes.regular && slot->affinity() == SlotStorage::AnyWorkers ) {
+                    own = slot;
+                    ownResult = result;
+                    continue;
+                }
+                lanes.submit(slots, next, [this, slot, result, &params]() {
+                    DispatchScope scope(this);
+                    measure(*slot, 1, [slot, result, &params]() { result->emplace(slot->apply<R, Args...>(params)); });
+                }, &group);
+                queued = true;
+            }
+            if( own ) {
+                measure(*own, 1, [own, ownResult, &args...]() { ownResult->emplace(own->invoke<R, Args...>(args...)); });
+            }
+            if( queued ) {
+                OBJECTSLOTS_TRACE_SCOPE("wait", slots.signal);
+                pending.wait();
+            } else {
+                pending.skip();
+            }
+            for( std::size_t i = 0; i < count; ++i ) {
+                if( !combiner.add(std::move(*results[i])) ) {
+                    return;
+                }
+                results[i].reset();
+            }
+        }
+    }
+
+    /**
+     * @brief Splits the slots of one signal into chunks of `grainSize()`, runs the
+     *        first on the calling thread and the others on the dispatcher, and waits
+     *        for all of them. The caller must hold the read lock, which keeps the
+     *        slot array unchanged until the wait is over.
+     */
+    template<class Invoke>
+    void fanOut(const Lanes& lanes, const SlotSpan slots, const Invoke& invoke) {
+        const std::size_t grain = grainSize();
+        const SlotStorage* const data = slots.data;
+        TaskGroup group;
+        // Slots with an affinity leave their chunk for a task of their own.
+        auto run = [this, data, &invoke, &lanes, &group](std::size_t begin, std::size_t end) {
+            bool submitted = false;
+            for( std::size_t i = begin; i < end; ++i ) {
+                if( data[i].affinity() == SlotStorage::AnyWorkers ) {
+                    invoke(data[i]);
+                    continue;
+                }
+                const SlotStorage* slot = &data[i];
+                lanes.regular->submit([this, slot, &invoke]() {
+                    DispatchScope scope(this);
+                    invoke(*slot);
+                }, &group, Lanes::workers(*slot));
+                submitted = true;
+            }
+            return submitted;
+        };
+        TaskWait pending(*lanes.regular, group);
+        // Urgent slots come first in the plan, each gets a task of its own.
+        const std::size_t urgent = lanes.urgent ? slots.urgentSlots : 0;
+        for( std::size_t i = 0; i < urgent; ++i ) {
+            lanes.submit(slots, i, [this, &invoke, data, i]() {
+                DispatchScope scope(this);
+                invoke(data[i]);
+            }, &group);
+        }
+        const std::size_t first = std::min(urgent + grain, slots.size);
+        for( std::size_t begin = first; begin < slots.size; begin += grain ) {
+            const std::size_t end = std::min(begin + grain, slots.size);
+            lanes.regular->submit([this, &run, begin, end]() {
+                DispatchScope scope(this);
+                run(begin, end);
+            }, &group);
+        }
+        const bool submitted = run(urgent, first);
+        if( urgent > 0 || first < slots.size || submitted ) {
+            OBJECTSLOTS_TRACE_SCOPE("wait", slots.signal);
+            pending.wait();
+        } else {
+            pending.skip();
+        }
+    }
+
+    /**
+     * @brief Queues the invocations of the slots of one signal and returns at once.
+     *        The caller must hold the read lock.
+     * @param track True to return a token that completes with the invocations.
+     */
+    template<class ... Args>
+    Completion detach(const Lanes& lanes, const SlotSpan slots, bool track, SlotArg<Args>... args) {
+        if( slots.size == 0 ) {
+            return Completion();
+        }
+        // The slot array may change once the lock is released, the
+        // queued invocations work on their own copy of it.
+        auto detached = new DetachedEmit<std::tuple<std::decay_t<Args>...>>(slots.data, slots.size, args...);
+        const std::size_t count = slots.size;
+        Completion completion = track ? Completion::make(lanes.regular->shared_from_this(), count) : Completion();
+        for( std::size_t i = 0; i < count; ++i ) {
+            lanes.submit(slots, i, [this, detached, i, state = completion.state_]() {
+                const SlotStorage& slot = detached->slots[i];
+                measure(slot, 1, [&slot, detached]() { slot.template apply<void, Args...>(detached->args); });
+                detached->release();
+                if( state ) {
+                    Completion::finish(*state);
+                }
+            }, &detachedTasks());
+        }
+        return completion;
+    }
+
+    template<class ... Args>
+    Completion emitChannelAsync(const void* signal, const Channel* channel, SlotArg<Args>... args) {
+        ReadLock lock(this, signal);
+        EmitPolicy policy;
+        const Lanes lanes = currentDispatcher(policy);
+        const SlotSpan slots = channelSlots(channel);
+        OBJECTSLOTS_TRACE_SCOPE("emit", slots.signal);
+        countEmit(slots, 1);
+        return detach<Args...>(lanes, slots, true, args...);
+    }
+#endif
+
+    /**
+     * @brief Times one slot invocation in statistics builds, `count` emits at once for a batch.
+     *        Tracing builds record it as a `slot` span.
+     */
+    template<class F>
+    void measure(const SlotStorage& slot, std::size_t count, F&& call) {
+        OBJECTSLOTS_TRACE_SCOPE("slot", slot.callback());
+#ifdef OBJECTSLOTS_STATS
+        const auto start = std::chrono::steady_clock::now();
+        call();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        recordInvoke(slot, count, static_cast<std::uint64_t>(elapsed.count()));
+#else
+        static_cast<void>(slot);
+        static_cast<void>(count);
+        call();
+#endif
+    }
+
+    void countEmit(const SlotSpan& slots, std::size_t count) {
+#ifdef OBJECTSLOTS_STATS
+        recordEmit(slots.channel, count);
+#else
+        static_cast<void>(slots);
+        static_cast<void>(count);
+#endif
+    }
+
+#ifdef OBJECTSLOTS_STATS
+    void recordEmit(const Channel*, std::size_t);
+    void recordInvoke(const SlotStorage&, std::size_t, std::uint64_t);
+#endif
+
+    SlotSpan getSlots(void*);
+    SlotSpan channelSlots(const Channel*);
+    Channel* attachSignal(const void*);
+    void detachSignal(const void*);
+    Connection slotStore(void*, const SlotStorage&, Priority = Priority::Normal);
+    void slotRemove(void*, void*);
+
+    friend class Receiver;
+    void track(Receiver*, const void*);
+    void untrack(Receiver*, const void*);
+
+    friend class Transaction;
+    void beginTransaction();
+    void endTransaction();
+    /**
+     * @brief Holds the read side of the slot storage of one signal while an emit runs.
+     *        Binds and unbinds made by its slots meanwhile are recorded, the
+     *        outermost one applies them once it released the lock.
+     *        Lives on the emitting thread's stack, so emitting never allocates a lock.
+     */
+    class ReadLock {
+    public:
+        ReadLock(ObjectSlots* owner, const void* signal) : owner_(owner), signal_(signal) { owner_->acquireLock(signal_); }
+        ~ReadLock() { owner_->releaseLock(signal_); }
+        ReadLock(const ReadLock&) = delete;
+        ReadLock& operator=(const ReadLock&) = delete;
+    private:
+        ObjectSlots* owner_;
+        const void* signal_;
+    };
+
+    /**
+     * @brief Marks a worker running slots of an emit whose lock the emitting thread
+     *        holds, so their binds and unbinds are recorded as well.
+     */
+    class DispatchScope {
+    public:
+#if defined(OBJECTSLOTS_THREAD_SAFE) && !defined(OBJECTSLOTS_LOCK_FREE)
+        explicit DispatchScope(ObjectSlots* owner) : owner_(owner) { owner_->enterDispatch(); }
+        ~DispatchScope() { owner_->leaveDispatch(); }
+    private:
+        ObjectSlots* owner_;
+#else
+        // Lock-free emits need no lock, other builds count emits per instance.
+        explicit DispatchScope(ObjectSlots*) { }
+#endif
+    public:
+        DispatchScope(const DispatchScope&) = delete;
+        DispatchScope& operator=(const DispatchScope&) = delete;
+    };
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief Waits for the tasks of an emit, which refer to the frame of the
+     *        emitting thread. Should a slot run on that thread or a `submit()`
+     *        throw before `wait()`, the destructor waits while the exception
+     *        unwinds, so no task outlives the frame.
+     */
+    class TaskWait {
+    public:
+        TaskWait(Dispatcher& dispatcher, TaskGroup& group) : dispatcher_(dispatcher), group_(group) { }
+        ~TaskWait() {
+            if( !done_ ) {
+                dispatcher_.wait(group_);
+            }
+        }
+        TaskWait(const TaskWait&) = delete;
+        TaskWait& operator=(const TaskWait&) = delete;
+
+        void wait() {
+            done_ = true;
+            dispatcher_.wait(group_);
+        }
+
+        /**
+         * @brief Nothing was queued, there is nothing to wait for.
+         */
+        void skip() { done_ = true; }
+
+    private:
+        Dispatcher& dispatcher_;
+        TaskGroup& group_;
+        bool done_ = false;
+    };
+#endif
+
+    void acquireLock(const void*);
+    void releaseLock(const void*);
+#ifndef OBJECTSLOTS_LOCK_FREE
+    void applyChanges();
+#endif
+#if defined(OBJECTSLOTS_THREAD_SAFE) && !defined(OBJECTSLOTS_LOCK_FREE)
+    void enterDispatch();
+    void leaveDispatch();
+#endif
+#ifdef OBJECTSLOTS_THREADED
+    Lanes currentDispatcher(EmitPolicy&);
+    TaskGroup& detachedTasks();
+#endif
+};
+
+/**
+ * @brief `Signal` is a typed signal declared as a member of an `ObjectSlots` subclass.
+ *
+ * The signal refers to its slot array directly, so emitting neither puns a
+ * member function pointer nor looks the signal up in the owner's table.
+ * Everything else is shared with the owner: its lock, dispatcher, emit
+ * policy and connection table. Connections, `unbind()` and `Receiver` work
+ * just like for signals emitted with `ObjectSlots::emit()`.
+ *
+ * Example Usage:
+ * ```cpp
+ * class MyEmitter : public ObjectSlots::ObjectSlots {
+ * public:
+ *     ObjectSlots::Signal<int> valueChanged{this};
+ * };
+ *
+ * emitter.valueChanged.bind(&receiver, &MyReceiver::memberFunctionSlot);
+ * emitter.valueChanged(42);
+ * ```
+ * @tparam Args The argument types of the signal and the slots.
+ */
+template<class ... Args>
+class Signal {
+public:
+    using Priority = ObjectSlots::Priority;
+
+    /**
+     * @param owner The instance the signal belongs to, it must outlive the signal.
+     */
+    explicit Signal(ObjectSlots* owner) : owner_(owner), channel_(owner->attachSignal(this)) {}
+    ~Signal() { owner_->detachSignal(this); }
+
+    Signal(const Signal&) = delete;
+    Signal& operator=(const Signal&) = delete;
+
+    /**
+     * @brief Binds a member function slot.
+     */
+    template<class T, class ... SlotArgs>
+    Connection bind(T* object, SlotMethodP<T, void, SlotArgs...> callback, Priority priority = Priority::Normal) {
+        return owner_->template bindMethod<void, Args...>(this, object, callback, priority);
+    }
+
+    /**
+     * @brief Binds a free function slot.
+     */
+    template<class ... SlotArgs>
+    Connection bind(SlotFunctionP<void, SlotArgs...> callback, Priority priority = Priority::Normal) {
+        return owner_->template bindFunction<void, Args...>(this, callback, priority);
+    }
+
+    /**
+     * @brief Binds a callable. Like `ObjectSlots::bind()`, its address identifies it on unbind.
+     */
+    template<typename Func>
+    Connection bind(Func&& f, Priority priority = Priority::Normal) {
+        return owner_->template bindCallable<void, Args...>(this, std::forward<Func>(f), priority);
+    }
+
+    /**
+     * @brief Binds a member function as a deferred slot, invoked by an `EventLoop` or a `Coalescer`.
+     */
+    template<class T, class Context, class ... SlotArgs>
+    std::enable_if_t<Deferral<Context>::value, Connection> bind(T* object, SlotMethodP<T, void, SlotArgs...> callback, Context& context) {
+        return owner_->template bindDeferredMethod<void, Args...>(this, object, callback, context);
+    }
+
+    /**
+     * @brief Binds a free function as a deferred slot, invoked by an `EventLoop` or a `Coalescer`.
+     */
+    template<class Context, class ... SlotArgs>
+    std::enable_if_t<Deferral<Context>::value, Connection> bind(SlotFunctionP<void, SlotArgs...> callback, Context& context) {
+        return owner_->template bindDeferredFunction<void, Args...>(this, callback, context);
+    }
+
+    /**
+     * @brief Binds a callable as a deferred slot, invoked by an `EventLoop` or a `Coalescer`.
+     */
+    template<typename Func, class Context>
+    std::enable_if_t<Deferral<Context>::value, Connection> bind(Func&& f, Context& context) {
+        return owner_->template bindDeferredCallable<void, Args...>(this, std::forward<Func>(f), context);
+    }
+
+    /**
+     * @brief Binds a batch-aware member function, see `ObjectSlots::bindBatch()`.
+     */
+    template<class T, class ... SlotArgs>
+    Connection bindBatch(T* object, SlotMethodP<T, void, SlotArgs...> callback) {
+        return owner_->template bindBatchMethod<Args...>(this, object, callback);
+    }
+
+    /**
+     * @brief Binds a batch-aware free function, see `ObjectSlots::bindBatch()`.
+     */
+    template<class ... SlotArgs>
+    Connection bindBatch(SlotFunctionP<void, SlotArgs...> callback) {
+        return owner_->template bindBatchFunction<Args...>(this, callback);
+    }
+
+    /**
+     * @brief Invokes all bound slots, forwarding the arguments like `ObjectSlots::emit()`.
+     */
+    template<class ... Params>
+    void emit(Params&& ... args) const {
+        static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of signal arguments");
+        owner_->template emitChannel<Args...>(this, channel_, static_cast<SlotArg<Args>>(std::forward<Params>(args))...);
+    }
+
+    template<class ... Params>
+    void operator()(Params&& ... args) const {
+        emit(std::forward<Params>(args)...);
+    }
+
+    /**
+     * @brief Emits once per element of a batch, like `ObjectSlots::emitBatch()`.
+     */
+    void emitBatch(const Batch<Args...>& batch) const {
+        owner_->template emitChannelBatch<Args...>(this, channel_, batch);
+    }
+
+#ifdef OBJECTSLOTS_THREADED
+    /**
+     * @brief Invokes all bound slots on the dispatcher and returns at once, like `ObjectSlots::emitAsync()`.
+     */
+    template<class ... Params>
+    Completion emitAsync(Params&& ... args) const {
+        static_assert(sizeof...(Params) == sizeof...(Args), "wrong number of signal arguments");
+        return owner_->template emitChannelAsync<Args...>(this, channel_, static_cast<SlotArg<Args>>(std::forward<Params>(args))...);
+    }
+#endif
+
+private:
+    ObjectSlots* owner_;
+    const ObjectSlots::Channel* channel_;
+};
+
+template<class Target, class ... Args>
+bool CoalescedState<Target, Args...>::fire() {
+    std::optional<std::tuple<std::decay_t<Args>...>> args;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if( !connected_ ) {
+            return false;
+        }
+        args.swap(latest_);
+    }
+    if( !args ) {
+        return false;
+    }
+    std::apply(target_, *args);
+    return true;
+}
+
 } // end namespace Slots
 
 #endif //_OBJECTSLOTS_HPP_
\ No newline at end of file
@@ -0,0 +1,293 @@
+#ifndef _OBJECTSLOTS_SHAREDBRIDGE_HPP_
+#define _OBJECTSLOTS_SHAREDBRIDGE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+#include <mutex>
+#endif
+
+#include "ObjectSlots/ObjectSlots.hpp"
+
+namespace ObjectSlots {
+
+/**
+ * @brief `SharedRing` is a ring of fixed-size elements in a named POSIX
+ *        shared-memory object, written by one producer and read by up to
+ *        `MaxReaders` readers, in any process of the host.
+ *
+ * Every reader sees every element. The producer never overwrites an element
+ * a joined reader has not consumed yet, a full ring makes it write fewer
+ * elements instead. Readers read the elements in place, in the mapped
+ * region, and sleep on a futex while the ring is empty; the producer only
+ * wakes them if one sleeps, once per `publish()`.
+ *
+ * Only one thread of one process may produce at a time. A reader that stops
+ * consuming without leaving holds the producer back until the ring is
+ * recreated. Without POSIX shared memory `create()` and `open()` fail.
+ */
+class SharedRing {
+public:
+    /** @brief The most readers that can join a ring at once. */
+    static constexpr std::size_t MaxReaders = 16;
+
+    /**
+     * @brief Creates a ring, replacing any shared-memory object of that name.
+     *        The name is removed again when the ring is destroyed.
+     * @param name The name of the shared-memory object, like `/sensor`.
+     * @param elementSize The size of an element, the stride of the ring.
+     * @param capacity The number of elements, rounded up to a power of two.
+     * @return The ring, or nullptr if the object could not be created.
+     */
+    static std::unique_ptr<SharedRing> create(const std::string& name, std::size_t elementSize, std::size_t capacity);
+
+    /**
+     * @brief Maps a ring another process created.
+     * @param elementSize The element size the ring must have been created with.
+     * @return The ring, or nullptr if there is none or its layout differs.
+     */
+    static std::unique_ptr<SharedRing> open(const std::string& name, std::size_t elementSize);
+
+    ~SharedRing();
+
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    std::size_t elementSize() const;
+    std::size_t capacity() const;
+
+    /**
+     * @brief Returns the storage of the element with a sequence number. The
+     *        elements with consecutive numbers are adjacent up to the end of
+     *        the ring, elements are aligned to 64 bytes at the start.
+     */
+    void* element(std::uint64_t sequence) const;
+
+    /**
+     * @brief Returns the sequence number of the next element the producer writes.
+     */
+    std::uint64_t head() const;
+
+    /**
+     * @brief Returns how many elements the producer may write from `head()` on.
+     */
+    std::size_t writable() const;
+
+    /**
+     * @brief Makes the next `count` elements visible to the readers and wakes
+     *        the sleeping ones. `count` must not exceed `writable()`.
+     */
+    void publish(std::size_t count);
+
+    /**
+     * @brief Adds elements the producer could not write to the shared count.
+     */
+    void drop(std::size_t count);
+
+    /**
+     * @brief Returns how many elements producers dropped while the ring was full.
+     */
+    std::uint64_t dropped() const;
+
+    /**
+     * @brief `Reader` consumes the elements of a ring from the ones published
+     *        after it joined on.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Joins a ring, `valid()` is false if `MaxReaders` already did.
+         */
+        explicit Reader(SharedRing& ring);
+
+        /**
+         * @brief Leaves the ring, the producer no longer waits for the reader.
+         */
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        bool valid() const { return index_ < MaxReaders; }
+
+        /**
+         * @brief Returns the sequence number of the next element to read.
+         */
+        std::uint64_t position() const { return position_; }
+
+        /**
+         * @brief Returns how many elements are published past `position()`.
+         */
+        std::size_t available() const;
+
+        /**
+         * @brief Returns the next element, valid until it is consumed.
+         */
+        const void* element() const { return ring_.element(position_); }
+
+        /**
+         * @brief Gives `count` elements back to the producer.
+         */
+        void consume(std::size_t count);
+
+        /**
+         * @brief Sleeps until an element is available or `timeout` has passed.
+         * @return The number of elements available.
+         */
+        std::size_t wait(std::chrono::nanoseconds timeout);
+
+    private:
+        SharedRing& ring_;
+        std::size_t index_;
+        std::uint64_t position_ = 0;
+    };
+
+private:
+    struct Header;
+
+    SharedRing(const std::string& name, void* region, std::size_t bytes, bool owner);
+
+    std::string name_;
+    Header* header_;
+    unsigned char* elements_;
+    std::size_t bytes_;
+    std::uint64_t mask_;
+    bool owner_;
+};
+
+/**
+ * @brief `SharedPublisher` writes the emits of a signal to a `SharedRing`,
+ *        for a `SharedSubscriber` in another process to re-emit.
+ *
+ * It is bound as a batch-aware slot, so an `emitBatch()` is written as a
+ * whole and wakes the readers once. The arguments are stored as the
+ * `Batch<Args...>::Element` of the signal, they must be trivially copyable
+ * and must not point into the memory of the process. Emits that do not fit
+ * into the ring are dropped and counted by `SharedRing::dropped()`.
+ *
+ * Example Usage:
+ * ```cpp
+ * auto ring = ObjectSlots::SharedRing::create("/sensor", sizeof(ObjectSlots::Batch<int, double>::Element), 4096);
+ * ObjectSlots::SharedPublisher<int, double> publisher(*ring);
+ * sensor.bindBatch(&Sensor::valueChanged, &publisher, &ObjectSlots::SharedPublisher<int, double>::publish);
+ * ```
+ * @tparam Args The argument types of the signal.
+ */
+template<class ... Args>
+class SharedPublisher {
+public:
+    using Element = typename Batch<Args...>::Element;
+    static_assert(std::conjunction_v<std::is_trivially_copyable<std::decay_t<Args>>...>,
+        "arguments of shared signals must be trivially copyable");
+
+    /**
+     * @param ring The ring, created for elements of `sizeof(Element)`. It must
+     *             outlive the publisher.
+     */
+    explicit SharedPublisher(SharedRing& ring) : ring_(ring) { }
+
+    /**
+     * @brief Writes the elements of a batch that fit into the ring.
+     */
+    void publish(const Batch<Args...>& batch) {
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+        // The ring has a single producer, emits may run the slot on several threads.
+        std::lock_guard<std::mutex> lock(mutex_);
+#endif
+        const std::size_t count = std::min(batch.size(), ring_.writable());
+        const std::uint64_t head = ring_.head();
+        for( std::size_t i = 0; i < count; ++i ) {
+            ::new (ring_.element(head + i)) Element(batch[i]);
+        }
+        if( count > 0 ) {
+            ring_.publish(count);
+        }
+        if( count < batch.size() ) {
+            ring_.drop(batch.size() - count);
+        }
+    }
+
+private:
+    SharedRing& ring_;
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+    std::mutex mutex_;
+#endif
+};
+
+/**
+ * @brief `SharedSubscriber` re-emits what a `SharedPublisher` wrote to a
+ *        `SharedRing` through a `Signal` of this process.
+ *
+ * The elements are handed to `Signal::emitBatch()` where they lie in the
+ * mapped region, in up to two batches per call: the ring wraps around once.
+ * An element is only given back to the producer once its emit returned.
+ *
+ * Example Usage:
+ * ```cpp
+ * auto ring = ObjectSlots::SharedRing::open("/sensor", sizeof(ObjectSlots::Batch<int, double>::Element));
+ * ObjectSlots::SharedSubscriber<int, double> subscriber(*ring, mirror.valueChanged);
+ * while( running ) {
+ *     subscriber.wait(std::chrono::milliseconds(100));
+ * }
+ * ```
+ * @tparam Args The argument types of the signal.
+ */
+template<class ... Args>
+class SharedSubscriber {
+public:
+    using Element = typename Batch<Args...>::Element;
+
+    /**
+     * @param ring The ring, it must outlive the subscriber.
+     * @param signal The signal to re-emit, it must outlive the subscriber.
+     */
+    SharedSubscriber(SharedRing& ring, const Signal<Args...>& signal) : reader_(ring), ring_(ring), signal_(signal) { }
+
+    /**
+     * @brief False if the ring had no room for another reader.
+     */
+    bool valid() const { return reader_.valid(); }
+
+    /**
+     * @brief Re-emits every element that is available.
+     * @return The number of elements re-emitted.
+     */
+    std::size_t poll() {
+        // Elements published meanwhile wait for the next call.
+        const std::size_t total = reader_.available();
+        for( std::size_t left = total; left > 0; ) {
+            // Up to the end of the ring, the elements are adjacent.
+            const std::size_t offset = static_cast<std::size_t>(reader_.position() & (ring_.capacity() - 1));
+            const std::size_t count = std::min(left, ring_.capacity() - offset);
+            const Element* first = std::launder(static_cast<const Element*>(reader_.element()));
+            signal_.emitBatch(Batch<Args...>(first, count));
+            reader_.consume(count);
+            left -= count;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Sleeps until elements are available or `timeout` has passed, then re-emits them.
+     * @return The number of elements re-emitted.
+     */
+    std::size_t wait(std::chrono::nanoseconds timeout) {
+        reader_.wait(timeout);
+        return poll();
+    }
+
+private:
+    SharedRing::Reader reader_;
+    SharedRing& ring_;
+    const Signal<Args...>& signal_;
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_SHAREDBRIDGE_HPP_
@@ -0,0 +1,229 @@
+#ifndef _OBJECTSLOTS_STATICOBJECTSLOTS_HPP_
+#define _OBJECTSLOTS_STATICOBJECTSLOTS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#ifdef OBJECTSLOTS_THREAD_SAFE
+#include <mutex>
+#endif
+
+#include "ObjectSlots/ObjectSlots.hpp"
+
+namespace ObjectSlots {
+
+/**
+ * @brief `FixedArena` is a memory resource over a buffer it is given, it never
+ *        asks any other resource for memory.
+ *
+ * Requests are rounded up to a power of two and carved from the buffer in
+ * order. Freed blocks go to a free list of their size, which later requests
+ * of that size take from first, so allocating and freeing take constant time
+ * and a steady workload uses a steady amount of the buffer. Once the buffer is
+ * used up `allocate()` throws `std::bad_alloc`. It is thread safe in builds
+ * with thread safety enabled.
+ */
+class FixedArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Blocks are aligned to their size, up to this. Larger alignments are refused.
+     */
+    static constexpr std::size_t MaxAlignment = 64;
+
+    /**
+     * @brief The smallest block, every block holds the link of its free list.
+     */
+    static constexpr std::size_t MinBlock = 16;
+
+    /**
+     * @brief Returns the size of the block a request of `bytes` takes.
+     */
+    static constexpr std::size_t blockSize(std::size_t bytes) {
+        std::size_t size = MinBlock;
+        while( size < bytes ) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    /**
+     * @param buffer The memory blocks are carved from, it must outlive the arena.
+     * @param bytes The size of `buffer`.
+     */
+    FixedArena(void* buffer, std::size_t bytes);
+    FixedArena(const FixedArena&) = delete;
+    FixedArena& operator=(const FixedArena&) = delete;
+
+    /**
+     * @brief Returns the size of the buffer.
+     */
+    std::size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Returns how much of the buffer was carved into blocks, free ones included.
+     */
+    std::size_t used() const;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t sizeClass(std::size_t bytes, std::size_t alignment);
+
+    static constexpr std::size_t SizeClasses = 8 * sizeof(std::size_t);
+
+    unsigned char* const buffer_;
+    const std::size_t capacity_;
+    std::size_t used_ = 0;
+    FreeBlock* free_[SizeClasses] = {};
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    mutable std::mutex mutex_;
+#endif
+};
+
+/**
+ * @brief Upper bounds of what an emitter keeps in its memory resource, which
+ *        `staticArenaBytes()` adds up. The library checks its own types
+ *        against them when it is built.
+ */
+struct StaticLayout {
+    /** @brief The state of the emitter itself. */
+    static constexpr std::size_t Instance = 2048;
+    /** @brief The channel of a signal that has slots. */
+    static constexpr std::size_t Channel = 128;
+    /** @brief An entry of the connection table. */
+    static constexpr std::size_t Connection = 32;
+    /** @brief An entry of the signal, object and receiver tables. */
+    static constexpr std::size_t Entry = 16;
+    /** @brief A removed slot waiting until no emit can still run it. */
+    static constexpr std::size_t Retired = sizeof(SlotStorage) + 8;
+    /** @brief A snapshot waiting until no emit can still read it, see `OBJECTSLOTS_LOCK_FREE`. */
+    static constexpr std::size_t RetiredSnapshot = 24;
+    /** @brief The slot list of a channel, without its slots. */
+    static constexpr std::size_t SlotList = 32;
+#ifdef OBJECTSLOTS_STATS
+    /** @brief The counters of one connection. */
+    static constexpr std::size_t Counters = (2 + LatencyHistogram::Buckets) * sizeof(std::uint64_t);
+    /** @brief The counters of the first chunk, each chunk is twice the one before. */
+    static constexpr std::size_t FirstCounterChunk = 64;
+#endif
+};
+
+/**
+ * @brief Returns the arena size an emitter needs for `signals` signals with
+ *        `slotsPerSignal` slots each, as `StaticObjectSlots` uses by default.
+ *
+ * It covers the tables, the channel, slot array and emit plan of every
+ * signal and, in lock-free builds, the snapshots emits may still read.
+ * Callables that do not fit into a `SlotStorage` and binds made from slots
+ * while their signal is emitted take room of their own, which the default
+ * leaves only a little of.
+ */
+constexpr std::size_t staticArenaBytes(std::size_t signals, std::size_t slotsPerSignal) {
+    const std::size_t connections = signals * slotsPerSignal;
+    // Every block may need padding to its alignment.
+    auto block = [](std::size_t bytes) { return FixedArena::blockSize(bytes) + FixedArena::MaxAlignment; };
+    auto table = [&block](std::size_t count) {
+        std::size_t entries = 8;
+        while( count * 2 > entries ) {
+            entries *= 2;
+        }
+        return block(entries * StaticLayout::Entry);
+    };
+#ifdef OBJECTSLOTS_LOCK_FREE
+    const std::size_t channel = block(StaticLayout::Channel) + block(slotsPerSignal * sizeof(SlotStorage));
+#else
+    // The slot array and the emit plan built from it.
+    const std::size_t channel = block(StaticLayout::Channel) + 2 * block(slotsPerSignal * sizeof(SlotStorage));
+#endif
+    std::size_t bytes = block(StaticLayout::Instance)
+        + block(connections * StaticLayout::Connection)
+        + block(connections * sizeof(std::uint32_t))
+        + table(signals) + table(connections) + table(connections)
+        + signals * channel;
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_LOCK_FREE)
+    bytes += block(connections * StaticLayout::Retired);
+#endif
+#ifdef OBJECTSLOTS_LOCK_FREE
+    // Every change publishes a copy of a list, the ones emits still read wait.
+    bytes += block((connections + signals) * StaticLayout::RetiredSnapshot);
+    bytes += 3 * (signals * (block(StaticLayout::SlotList) + block(slotsPerSignal * sizeof(SlotStorage))) + table(signals));
+#endif
+#ifdef OBJECTSLOTS_STATS
+    for( std::size_t chunk = StaticLayout::FirstCounterChunk, reserved = 0; reserved < connections; reserved += chunk, chunk *= 2 ) {
+        bytes += block(chunk * StaticLayout::Counters);
+    }
+#endif
+    // Room for a few deferred binds and callables stored out of line.
+    return bytes + block(StaticLayout::Instance);
+}
+
+/**
+ * @brief Holds the arena of a `StaticObjectSlots`. It is a base class, so the
+ *        arena is constructed before the emitter allocates from it.
+ */
+template<std::size_t Bytes>
+class StaticArena {
+protected:
+    StaticArena() : arena_(buffer_, Bytes) { }
+
+    alignas(FixedArena::MaxAlignment) unsigned char buffer_[Bytes];
+    FixedArena arena_;
+};
+
+/**
+ * @brief `StaticObjectSlots` is an `ObjectSlots` whose memory is part of the
+ *        instance, for targets that must not allocate from the heap once
+ *        they are running.
+ *
+ * Everything the emitter keeps lives in a `FixedArena` over a buffer of
+ * `ArenaBytes` inside the instance, sized at compile time. Its tables are
+ * sized for `MaxSignals * MaxSlotsPerSignal` connections when it is
+ * constructed, so up to that many binds, their unbinds and every emit never
+ * grow them; a signal takes its slot array from the arena on its first
+ * bind, from a free list once one was released. Binding past the capacity
+ * takes more of the arena while it lasts, then `bind()` throws
+ * `std::bad_alloc`. Threaded builds emit inline by default, since
+ * dispatchers queue their tasks on the heap.
+ *
+ * Example Usage:
+ * ```cpp
+ * class Controller : public ObjectSlots::StaticObjectSlots<8, 4> {
+ * public:
+ *     void signal_setpoint(double value) {
+ *         emit( &Controller::signal_setpoint, value );
+ *     }
+ * };
+ * ```
+ *
+ * @tparam MaxSignals The signals the emitter is sized for.
+ * @tparam MaxSlotsPerSignal The slots per signal the emitter is sized for.
+ * @tparam ArenaBytes The size of the arena, `staticArenaBytes()` by default.
+ */
+template<std::size_t MaxSignals, std::size_t MaxSlotsPerSignal,
+         std::size_t ArenaBytes = staticArenaBytes(MaxSignals, MaxSlotsPerSignal)>
+class StaticObjectSlots : private StaticArena<ArenaBytes>, public ObjectSlots {
+public:
+    static constexpr Capacity capacity{ MaxSignals, MaxSlotsPerSignal };
+
+    StaticObjectSlots() : StaticArena<ArenaBytes>(), ObjectSlots(capacity, &this->arena_) {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    /**
+     * @brief Returns the arena the emitter allocates from.
+     */
+    const FixedArena& arena() const { return this->arena_; }
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_STATICOBJECTSLOTS_HPP_
@@ -0,0 +1,86 @@
+#ifndef _OBJECTSLOTS_STATS_HPP_
+#define _OBJECTSLOTS_STATS_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ObjectSlots {
+
+/**
+ * @brief `LatencyHistogram` counts slot invocations by how long they took,
+ *        in power-of-two buckets: bucket `i` holds the invocations that took
+ *        from `2^i` up to `2^(i+1)` nanoseconds, bucket 0 also the faster ones.
+ */
+struct LatencyHistogram {
+    static constexpr std::size_t Buckets = 40;
+
+    std::array<std::uint64_t, Buckets> counts{};
+
+    /**
+     * @brief Returns the bucket an invocation of `nanoseconds` is counted in.
+     */
+    static std::size_t bucket(std::uint64_t nanoseconds) {
+        std::size_t index = 0;
+        while( nanoseconds > 1 && index + 1 < Buckets ) {
+            nanoseconds >>= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    /**
+     * @brief Returns the number of invocations counted.
+     */
+    std::uint64_t count() const {
+        std::uint64_t total = 0;
+        for( std::uint64_t bucket : counts ) {
+            total += bucket;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns an upper bound in nanoseconds for the given fraction of
+     *        the invocations, e.g. 0.99 for the 99th percentile.
+     */
+    std::uint64_t percentile(double fraction) const {
+        const double wanted = fraction * static_cast<double>(count());
+        std::uint64_t seen = 0;
+        for( std::size_t i = 0; i < Buckets; ++i ) {
+            seen += counts[i];
+            if( counts[i] && static_cast<double>(seen) >= wanted ) {
+                return std::uint64_t(2) << i;
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * @brief What was recorded for one bound slot.
+ */
+struct SlotStats {
+    /** @brief The object and callback identifying the slot, as used by `unbind()`. */
+    const void* object;
+    const void* callback;
+    std::uint64_t invocations;
+    /** @brief The total time spent in the slot. */
+    std::uint64_t nanoseconds;
+    LatencyHistogram latency;
+};
+
+/**
+ * @brief What was recorded for one signal and the slots currently bound to it.
+ */
+struct SignalStats {
+    /** @brief The signal, see `ObjectSlots::signalId()`. */
+    const void* signal;
+    std::uint64_t emits;
+    std::vector<SlotStats> slots;
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_STATS_HPP_
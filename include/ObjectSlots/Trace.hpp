@@ -0,0 +1,88 @@
+#ifndef _OBJECTSLOTS_TRACE_HPP_
+#define _OBJECTSLOTS_TRACE_HPP_
+
+#include <cstddef>
+#include <ostream>
+
+namespace ObjectSlots {
+
+/**
+ * @brief `Trace` records begin and end events into per-thread ring buffers
+ *        and writes them as a Chrome trace, which chrome://tracing and the
+ *        Perfetto UI open directly.
+ *
+ * With `OBJECTSLOTS_ENABLE_TRACING` on, every emit records an `emit` span on
+ * the emitting thread, a `slot` span for each slot on the thread that runs
+ * it, and a `wait` span while `emit()` waits for the dispatcher. Without the
+ * option the hooks compile to nothing; the class itself is always there, so
+ * applications can add their own spans.
+ *
+ * Each thread writes to its own buffer, which keeps the newest
+ * `BufferSize` events. Buffers of finished threads are reused by new ones
+ * and keep their row in the trace.
+ *
+ * Example Usage:
+ * ```cpp
+ * std::ofstream file("emits.json");
+ * ObjectSlots::Trace::writeChromeJson(file);
+ * ```
+ */
+class Trace {
+public:
+    static constexpr std::size_t BufferSize = 16384;
+
+    /**
+     * @brief Opens a span on the calling thread.
+     * @param name A string literal, it is stored by address.
+     * @param id Identifies what the span is about, e.g. a signal. Written as an argument.
+     */
+    static void begin(const char* name, const void* id = nullptr);
+
+    /**
+     * @brief Closes the innermost open span of the calling thread.
+     */
+    static void end(const char* name, const void* id = nullptr);
+
+    /**
+     * @brief Names the row of the calling thread.
+     * @param name A string literal, it is stored by address.
+     */
+    static void nameThread(const char* name);
+
+    /**
+     * @brief Writes the events of every thread in the Chrome trace event format.
+     */
+    static void writeChromeJson(std::ostream& out);
+
+    /**
+     * @brief Drops every recorded event.
+     */
+    static void clear();
+};
+
+/**
+ * @brief Records a span from construction to destruction.
+ */
+class TraceScope {
+public:
+    TraceScope(const char* name, const void* id = nullptr) : name_(name), id_(id) { Trace::begin(name, id); }
+    ~TraceScope() { Trace::end(name_, id_); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    const char* name_;
+    const void* id_;
+};
+
+} // end namespace Slots
+
+#ifdef OBJECTSLOTS_ENABLE_TRACING
+#define OBJECTSLOTS_TRACING
+#define OBJECTSLOTS_TRACE_CAT_(a, b) a##b
+#define OBJECTSLOTS_TRACE_CAT(a, b) OBJECTSLOTS_TRACE_CAT_(a, b)
+#define OBJECTSLOTS_TRACE_SCOPE(name, id) ::ObjectSlots::TraceScope OBJECTSLOTS_TRACE_CAT(traceScope, __LINE__)(name, id)
+#else
+#define OBJECTSLOTS_TRACE_SCOPE(name, id) do { } while( 0 )
+#endif
+
+#endif //_OBJECTSLOTS_TRACE_HPP_
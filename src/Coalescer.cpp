@@ -0,0 +1,79 @@
+#include "ObjectSlots/Coalescer.hpp"
+#include "ObjectSlots/EventLoop.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace ObjectSlots {
+
+struct Coalescer::impl {
+    using Clock = std::chrono::steady_clock;
+
+    mutable std::mutex mutex;
+    std::vector<std::weak_ptr<Pending>> queue;
+    Clock::time_point since;
+    std::chrono::nanoseconds budget{0};
+    EventLoop* loop = nullptr;
+};
+
+Coalescer::Coalescer(std::chrono::nanoseconds budget) : impl_(new impl()) {
+    impl_->budget = budget;
+}
+
+Coalescer::Coalescer(EventLoop& loop) : impl_(new impl()) {
+    impl_->loop = &loop;
+}
+
+Coalescer::~Coalescer() {
+    delete impl_;
+}
+
+void Coalescer::schedule(std::weak_ptr<Pending> pending) {
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        first = impl_->queue.empty();
+        if( first ) {
+            impl_->since = impl::Clock::now();
+        }
+        impl_->queue.push_back(std::move(pending));
+    }
+    // One flush per turn, emits until then join the queue.
+    if( first && impl_->loop ) {
+        impl_->loop->post([this]() { flush(); });
+    }
+}
+
+std::size_t Coalescer::flush() {
+    std::vector<std::weak_ptr<Pending>> queue;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        queue.swap(impl_->queue);
+    }
+    std::size_t fired = 0;
+    for( auto& entry : queue ) {
+        // Expired once the slot was destroyed.
+        auto pending = entry.lock();
+        if( pending && pending->fire() ) {
+            ++fired;
+        }
+    }
+    return fired;
+}
+
+std::size_t Coalescer::poll() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if( impl_->queue.empty() || impl::Clock::now() - impl_->since < impl_->budget ) {
+            return 0;
+        }
+    }
+    return flush();
+}
+
+std::size_t Coalescer::pending() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->queue.size();
+}
+
+} // end namespace Slots
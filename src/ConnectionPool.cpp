@@ -0,0 +1,33 @@
+#include "ObjectSlots/ConnectionPool.hpp"
+
+namespace ObjectSlots {
+
+namespace {
+
+std::pmr::pool_options connectionPoolOptions() {
+    std::pmr::pool_options options;
+    // Slot arrays usually hold a few slots, keep chunks small so an
+    // emitter with a handful of signals does not reserve much memory.
+    options.max_blocks_per_chunk = 64;
+    options.largest_required_pool_block = ConnectionPool::LargestBlock;
+    return options;
+}
+
+}
+
+ConnectionPool::ConnectionPool(std::pmr::memory_resource* upstream)
+    : pool_(connectionPoolOptions(), upstream) { }
+
+void* ConnectionPool::do_allocate(std::size_t bytes, std::size_t alignment) {
+    return pool_.allocate(bytes, alignment);
+}
+
+void ConnectionPool::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    pool_.deallocate(p, bytes, alignment);
+}
+
+bool ConnectionPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // end namespace Slots
@@ -0,0 +1,475 @@
+#include "ObjectSlots/Dispatcher.hpp"
+#include "ObjectSlots/Trace.hpp"
+
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ObjectSlots {
+
+void TaskGroup::finish() {
+    // The waiter re-acquires the mutex before returning, so the group
+    // is not destroyed while it is still being notified.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if( pending_.fetch_sub(1, std::memory_order_acq_rel) == 1 ) {
+        finished_.notify_all();
+    }
+}
+
+struct Dispatcher::impl {
+    struct Entry {
+        Task task;
+        TaskGroup* group;
+    };
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Entry> tasks;
+    };
+
+    /**
+     * @brief The workers of one `WorkerGroup` and the tasks submitted to it,
+     *        which only they run.
+     */
+    struct Group {
+        explicit Group(WorkerGroup spec) : spec(std::move(spec)) { }
+        WorkerGroup spec;
+        Queue queue;
+        std::atomic<std::size_t> pending{0};
+        std::atomic<std::size_t> sleeping{0};
+        std::condition_variable idle;
+    };
+
+    explicit impl(std::vector<WorkerGroup> specs) {
+        for( WorkerGroup& spec : specs ) {
+            if( spec.workers == 0 ) {
+                spec.workers = spec.cpus.empty() ? std::thread::hardware_concurrency() : spec.cpus.size();
+            }
+            if( spec.workers == 0 ) {
+                spec.workers = 1;
+            }
+            for( unsigned cpu : spec.cpus ) {
+                if( cpu >= cpuGroup.size() ) {
+                    cpuGroup.resize(cpu + 1, AnyGroup);
+                }
+                if( cpuGroup[cpu] == AnyGroup ) {
+                    cpuGroup[cpu] = groups.size();
+                }
+            }
+            groupOf.insert(groupOf.end(), spec.workers, groups.size());
+            groups.emplace_back(std::move(spec));
+        }
+        queues.resize(groupOf.size());
+    }
+
+    bool popLocal(std::size_t index, Entry& entry) {
+        Queue& queue = queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if( queue.tasks.empty() ) {
+            return false;
+        }
+        entry = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool popGroup(Group& group, Entry& entry) {
+        if( group.pending.load(std::memory_order_relaxed) == 0 ) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(group.queue.mutex);
+        if( group.queue.tasks.empty() ) {
+            return false;
+        }
+        entry = std::move(group.queue.tasks.front());
+        group.queue.tasks.pop_front();
+        group.pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool steal(std::size_t start, Entry& entry) {
+        for( std::size_t i = 0; i < queues.size(); ++i ) {
+            Queue& queue = queues[(start + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if( !queue.tasks.empty() ) {
+                entry = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void execute(Entry& entry) noexcept {
+        entry.task();
+        entry.task = nullptr;
+        if( entry.group ) {
+            entry.group->finish();
+        }
+    }
+
+    /**
+     * @brief Wakes a sleeping worker for a task any of them may run.
+     */
+    void wakeAny() {
+        for( Group& group : groups ) {
+            if( group.sleeping.load() > 0 ) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                group.idle.notify_one();
+                return;
+            }
+        }
+    }
+
+    void work(std::size_t index);
+
+    std::deque<Queue> queues;
+    std::deque<Group> groups;
+    /** @brief The group of every worker, the workers of a group are adjacent. */
+    std::vector<std::size_t> groupOf;
+    /** @brief The first group of every CPU, `AnyGroup` for CPUs of none. */
+    std::vector<std::size_t> cpuGroup;
+    std::vector<std::thread> workers;
+    /** @brief The tasks in the worker queues, the group queues count their own. */
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> next{0};
+    bool stop = false;
+    /** @brief Set once the pool was destroyed by one of its own tasks, that worker frees it. */
+    bool orphaned = false;
+    std::mutex idleMutex;
+};
+
+namespace {
+// Identifies the pool and queue of the worker running on this thread.
+thread_local const void* currentPool = nullptr;
+thread_local std::size_t currentQueue = 0;
+
+std::mutex globalMutex;
+std::shared_ptr<Dispatcher> globalDispatcher;
+
+/**
+ * @brief Pins the calling thread to `cpus`. Where that is not supported, or
+ *        not allowed, the thread stays where the scheduler puts it.
+ */
+void pin(const std::vector<unsigned>& cpus) {
+#ifdef __linux__
+    if( cpus.empty() ) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for( unsigned cpu : cpus ) {
+        if( cpu < CPU_SETSIZE ) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    static_cast<void>(cpus);
+#endif
+}
+
+#ifdef __linux__
+/**
+ * @brief Parses a CPU or node list of sysfs, like `0-3,8-11`.
+ */
+std::vector<unsigned> parseList(const std::string& text) {
+    std::vector<unsigned> list;
+    std::size_t position = 0;
+    while( position < text.size() ) {
+        std::size_t end = text.find(',', position);
+        if( end == std::string::npos ) {
+            end = text.size();
+        }
+        const std::string range = text.substr(position, end - position);
+        const std::size_t dash = range.find('-');
+        try {
+            const unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            const unsigned last = dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            for( unsigned i = first; i <= last; ++i ) {
+                list.push_back(i);
+            }
+        } catch( const std::exception& ) {
+            // Not a number, sysfs lists end with a newline.
+        }
+        position = end + 1;
+    }
+    return list;
+}
+
+std::vector<unsigned> readList(const std::string& path) {
+    std::ifstream file(path);
+    std::string text;
+    std::getline(file, text);
+    return parseList(text);
+}
+#endif
+}
+
+void Dispatcher::impl::work(std::size_t index) {
+    currentPool = this;
+    currentQueue = index;
+    Group& group = groups[groupOf[index]];
+    pin(group.spec.cpus);
+#ifdef OBJECTSLOTS_TRACING
+    Trace::nameThread("ObjectSlots dispatcher");
+#endif
+    Entry entry;
+    for(;;) {
+        if( popLocal(index, entry) || popGroup(group, entry) || steal(index + 1, entry) ) {
+            execute(entry);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idleMutex);
+        group.sleeping.fetch_add(1);
+        if( queued.load() == 0 && group.pending.load() == 0 ) {
+            if( stop ) {
+                group.sleeping.fetch_sub(1);
+                break;
+            }
+            group.idle.wait(lock);
+        }
+        group.sleeping.fetch_sub(1);
+    }
+    currentPool = nullptr;
+    if( orphaned ) {
+        delete this;
+    }
+}
+
+Dispatcher::Dispatcher(std::size_t workers) : Dispatcher(std::vector<WorkerGroup>{ WorkerGroup{ {}, {}, workers } }) { }
+
+Dispatcher::Dispatcher(std::vector<WorkerGroup> groups) {
+    if( groups.empty() ) {
+        groups.emplace_back();
+    }
+    impl_ = new impl(std::move(groups));
+    impl_->workers.reserve(impl_->groupOf.size());
+    for( std::size_t i = 0; i < impl_->groupOf.size(); ++i ) {
+        impl_->workers.emplace_back(&impl::work, impl_, i);
+    }
+}
+
+Dispatcher::~Dispatcher() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->idleMutex);
+        impl_->stop = true;
+    }
+    for( impl::Group& group : impl_->groups ) {
+        group.idle.notify_all();
+    }
+    // The last owner may be a task, a `Completion` it finishes keeps the
+    // pool alive. Its worker cannot join itself, it runs the tasks left
+    // and frees the pool once it stops.
+    bool orphaned = false;
+    for( auto& worker : impl_->workers ) {
+        if( worker.get_id() == std::this_thread::get_id() ) {
+            orphaned = true;
+            worker.detach();
+        } else {
+            worker.join();
+        }
+    }
+    if( orphaned ) {
+        impl_->orphaned = true;
+    } else {
+        delete impl_;
+    }
+}
+
+void Dispatcher::submit(Task task, TaskGroup* group, std::size_t workers) {
+    if( group ) {
+        group->add();
+    }
+    if( workers == CallerGroup ) {
+        workers = currentGroup();
+    }
+    if( workers < impl_->groups.size() ) {
+        impl::Group& target = impl_->groups[workers];
+        {
+            std::lock_guard<std::mutex> lock(target.queue.mutex);
+            target.queue.tasks.push_back({ std::move(task), group });
+        }
+        // Only the group's workers may run it, one of them is woken.
+        target.pending.fetch_add(1);
+        if( target.sleeping.load() > 0 ) {
+            std::lock_guard<std::mutex> lock(impl_->idleMutex);
+            target.idle.notify_one();
+        }
+        return;
+    }
+    const std::size_t index = currentPool == impl_
+        ? currentQueue
+        : impl_->next.fetch_add(1, std::memory_order_relaxed) % impl_->queues.size();
+    {
+        impl::Queue& queue = impl_->queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({ std::move(task), group });
+    }
+    // Pairs with the sleeping/queued check in impl::work(), both sides
+    // use sequentially consistent operations so a wakeup is never lost.
+    impl_->queued.fetch_add(1);
+    impl_->wakeAny();
+}
+
+void Dispatcher::wait(TaskGroup& group) {
+    const bool worker = currentPool == impl_;
+    const std::size_t start = worker ? currentQueue : 0;
+    // Other threads leave the tasks of a group to its workers.
+    impl::Group* own = worker ? &impl_->groups[impl_->groupOf[start]] : nullptr;
+    impl::Entry entry;
+    while( !group.done() ) {
+        if( (worker && (impl_->popLocal(start, entry) || impl_->popGroup(*own, entry))) || impl_->steal(start, entry) ) {
+            impl::execute(entry);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(group.mutex_);
+        group.finished_.wait_for(lock, std::chrono::milliseconds(1), [&group]() { return group.done(); });
+    }
+    std::lock_guard<std::mutex> lock(group.mutex_);
+}
+
+std::size_t Dispatcher::size() const {
+    return impl_->workers.size();
+}
+
+std::size_t Dispatcher::groupCount() const {
+    return impl_->groups.size();
+}
+
+const WorkerGroup& Dispatcher::group(std::size_t index) const {
+    return impl_->groups[index].spec;
+}
+
+std::size_t Dispatcher::findGroup(std::string_view name) const {
+    for( std::size_t i = 0; i < impl_->groups.size(); ++i ) {
+        if( impl_->groups[i].spec.name == name ) {
+            return i;
+        }
+    }
+    return AnyGroup;
+}
+
+std::size_t Dispatcher::currentGroup() const {
+    if( currentPool == impl_ ) {
+        return impl_->groupOf[currentQueue];
+    }
+#ifdef __linux__
+    const int cpu = sched_getcpu();
+    if( cpu >= 0 && static_cast<std::size_t>(cpu) < impl_->cpuGroup.size() ) {
+        return impl_->cpuGroup[static_cast<std::size_t>(cpu)];
+    }
+#endif
+    return AnyGroup;
+}
+
+std::vector<WorkerGroup> Dispatcher::nodes() {
+    std::vector<WorkerGroup> groups;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool restricted = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for( unsigned node : readList("/sys/devices/system/node/online") ) {
+        WorkerGroup group{ "node" + std::to_string(node), {}, 0 };
+        for( unsigned cpu : readList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist") ) {
+            if( !restricted || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) ) {
+                group.cpus.push_back(cpu);
+            }
+        }
+        if( !group.cpus.empty() ) {
+            groups.push_back(std::move(group));
+        }
+    }
+#endif
+    if( groups.empty() ) {
+        groups.push_back({ "node0", {}, 0 });
+    }
+    return groups;
+}
+
+std::shared_ptr<Dispatcher> Dispatcher::global() {
+    std::lock_guard<std::mutex> lock(globalMutex);
+    if( !globalDispatcher ) {
+        globalDispatcher = std::make_shared<Dispatcher>();
+    }
+    return globalDispatcher;
+}
+
+void Dispatcher::setGlobal(std::shared_ptr<Dispatcher> dispatcher) {
+    std::lock_guard<std::mutex> lock(globalMutex);
+    globalDispatcher = std::move(dispatcher);
+}
+
+struct Completion::State {
+    TaskGroup group;
+    // The emitter may switch or drop its dispatcher while the tasks run.
+    std::shared_ptr<Dispatcher> dispatcher;
+    std::function<void()> continuation;
+};
+
+Completion Completion::make(std::shared_ptr<Dispatcher> dispatcher, std::size_t tasks) {
+    auto state = std::make_shared<State>();
+    state->dispatcher = std::move(dispatcher);
+    state->group.add(tasks);
+    return Completion(std::move(state));
+}
+
+void Completion::finish(State& state) {
+    std::function<void()> continuation;
+    {
+        std::lock_guard<std::mutex> lock(state.group.mutex_);
+        if( state.group.pending_.fetch_sub(1, std::memory_order_acq_rel) == 1 ) {
+            state.group.finished_.notify_all();
+            continuation = std::move(state.continuation);
+        }
+    }
+    if( continuation ) {
+        // Not resumed inline: the coroutine may destroy the emitter, whose
+        // destructor waits for the very task that is finishing here.
+        state.dispatcher->submit(std::move(continuation));
+    }
+}
+
+bool Completion::ready() const {
+    return !state_ || state_->group.done();
+}
+
+void Completion::wait() const {
+    if( state_ ) {
+        state_->dispatcher->wait(state_->group);
+    }
+}
+
+bool Completion::waitFor(std::chrono::nanoseconds timeout) const {
+    if( !state_ ) {
+        return true;
+    }
+    TaskGroup& group = state_->group;
+    std::unique_lock<std::mutex> lock(group.mutex_);
+    return group.finished_.wait_for(lock, timeout, [&group]() { return group.done(); });
+}
+
+bool Completion::suspend(std::function<void()> resume) const {
+    if( !state_ ) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state_->group.mutex_);
+    if( state_->group.done() ) {
+        return false;
+    }
+    state_->continuation = std::move(resume);
+    return true;
+}
+
+} // end namespace Slots
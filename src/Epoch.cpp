@@ -0,0 +1,148 @@
+#include "Epoch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace ObjectSlots {
+
+namespace {
+
+// One record per thread that ever entered a critical section. Records are
+// never freed, a thread releases its record on exit for reuse by others.
+struct alignas(64) Record {
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<bool> used{true};
+    std::size_t depth = 0;
+    Record* next = nullptr;
+};
+
+struct Retired {
+    void* object;
+    void (*deleter)(void*);
+    std::uint64_t tag;
+};
+
+struct Domain {
+    ~Domain() {
+        // No reader is left once static objects are destroyed.
+        for( auto& item : retired ) {
+            item.deleter(item.object);
+        }
+    }
+
+    std::atomic<std::uint64_t> global{1};
+    std::atomic<Record*> records{nullptr};
+    std::mutex mutex;
+    std::vector<Retired> retired;
+};
+
+Domain& domain() {
+    static Domain instance;
+    return instance;
+}
+
+Record* acquireRecord() {
+    Domain& d = domain();
+    for( Record* record = d.records.load(std::memory_order_acquire); record; record = record->next ) {
+        bool expected = false;
+        if( !record->used.load(std::memory_order_relaxed) &&
+            record->used.compare_exchange_strong(expected, true, std::memory_order_acquire) ) {
+            return record;
+        }
+    }
+    Record* record = new Record();
+    record->next = d.records.load(std::memory_order_relaxed);
+    while( !d.records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed) ) { }
+    return record;
+}
+
+struct ThreadRecord {
+    ThreadRecord() : record(acquireRecord()) { }
+    ~ThreadRecord() {
+        record->epoch.store(0, std::memory_order_release);
+        record->depth = 0;
+        record->used.store(false, std::memory_order_release);
+    }
+    Record* record;
+};
+
+Record* threadRecord() {
+    thread_local ThreadRecord local;
+    return local.record;
+}
+
+}
+
+void Epoch::enter() {
+    Record* record = threadRecord();
+    if( record->depth++ == 0 ) {
+        record->epoch.store(domain().global.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // Publishes the epoch before any shared pointer is read, pairs
+        // with the fence in tag() and oldest().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+void Epoch::leave() {
+    Record* record = threadRecord();
+    if( --record->depth == 0 ) {
+        record->epoch.store(0, std::memory_order_release);
+    }
+}
+
+std::uint64_t Epoch::tag() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return domain().global.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::uint64_t Epoch::oldest() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for( Record* record = domain().records.load(std::memory_order_acquire); record; record = record->next ) {
+        const std::uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+        if( epoch != 0 && epoch < oldest ) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+void Epoch::retire(void* object, void (*deleter)(void*)) {
+    const std::uint64_t tagged = tag();
+    Domain& d = domain();
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.retired.push_back({ object, deleter, tagged });
+    }
+    reclaim();
+}
+
+void Epoch::reclaim() {
+    Domain& d = domain();
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        if( d.retired.empty() ) {
+            return;
+        }
+        const std::uint64_t limit = oldest();
+        auto keep = d.retired.begin();
+        for( auto& item : d.retired ) {
+            if( item.tag < limit ) {
+                ready.push_back(item);
+            } else {
+                *keep++ = item;
+            }
+        }
+        d.retired.erase(keep, d.retired.end());
+    }
+    // Deleters run outside the lock, they may retire further objects.
+    for( auto& item : ready ) {
+        item.deleter(item.object);
+    }
+}
+
+} // end namespace Slots
@@ -0,0 +1,66 @@
+#ifndef _OBJECTSLOTS_EPOCH_HPP_
+#define _OBJECTSLOTS_EPOCH_HPP_
+
+#include <cstdint>
+
+namespace ObjectSlots {
+
+/**
+ * @brief `Epoch` implements process-wide epoch based reclamation for the
+ *        lock-free emit path.
+ *
+ * Readers wrap every access to shared snapshots in `enter()`/`leave()`,
+ * which only touches a per-thread record. A writer first unlinks an object
+ * so no new reader can reach it, then retires it. A retired object is
+ * freed once every reader that was inside a critical section at the time
+ * it was retired has left it.
+ *
+ * Critical sections nest, so a slot may emit further signals.
+ */
+class Epoch {
+public:
+    /**
+     * @brief `Guard` keeps the calling thread inside a critical section.
+     */
+    class Guard {
+    public:
+        Guard() { enter(); }
+        ~Guard() { leave(); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    static void enter();
+    static void leave();
+
+    /**
+     * @brief Returns the tag of objects unlinked before this call.
+     *        The objects may be freed once `oldest()` is greater than the tag.
+     */
+    static std::uint64_t tag();
+
+    /**
+     * @brief Returns the oldest epoch a reader is still in, or UINT64_MAX
+     *        when no reader is inside a critical section.
+     */
+    static std::uint64_t oldest();
+
+    /**
+     * @brief Frees an unlinked object with `deleter` once no reader can see it.
+     */
+    static void retire(void* object, void (*deleter)(void*));
+
+    template<class T>
+    static void retire(T* object) {
+        retire(const_cast<void*>(static_cast<const void*>(object)), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /**
+     * @brief Frees the retired objects that no reader can see anymore.
+     */
+    static void reclaim();
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_EPOCH_HPP_
@@ -0,0 +1,167 @@
+#include "ObjectSlots/EventLoop.hpp"
+#include "ObjectSlots/Trace.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ObjectSlots {
+
+/**
+ * The queue is a ring of cells with a sequence number each, as described by
+ * Dmitry Vyukov for bounded MPMC queues. A producer claims a position with
+ * one compare-and-swap and publishes the cell through its sequence number;
+ * the single consumer needs no atomic read-modify-write at all.
+ */
+struct EventLoop::impl {
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> sequence;
+        Event event;
+    };
+
+    explicit impl(std::size_t size) : mask(size - 1), cells(new Cell[size]) {
+        for( std::size_t i = 0; i < size; ++i ) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(Event& event) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        for( ;; ) {
+            Cell& cell = cells[position & mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if( sequence == position ) {
+                if( tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) ) {
+                    cell.event = std::move(event);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if( sequence < position ) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(Event& event) {
+        Cell& cell = cells[head & mask];
+        if( cell.sequence.load(std::memory_order_acquire) != head + 1 ) {
+            return false;
+        }
+        event = std::move(cell.event);
+        cell.event = nullptr;
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    void wake() {
+        // Pairs with the fence in run(), either the sleeper sees the
+        // event or the producer sees the sleeper.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if( sleeping.load(std::memory_order_relaxed) ) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idle.notify_one();
+        }
+    }
+
+    bool empty() const {
+        return cells[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<std::size_t> tail{0};
+    alignas(64) std::size_t head = 0;
+    std::atomic<std::thread::id> consumer{};
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stop{false};
+    std::mutex idleMutex;
+    std::condition_variable idle;
+};
+
+namespace {
+
+std::size_t roundCapacity(std::size_t capacity) {
+    std::size_t size = 2;
+    while( size < capacity ) {
+        size *= 2;
+    }
+    return size;
+}
+
+}
+
+EventLoop::EventLoop(std::size_t capacity) : impl_(new impl(roundCapacity(capacity))) { }
+
+EventLoop::~EventLoop() {
+    delete impl_;
+}
+
+void EventLoop::post(Event event) {
+    while( !impl_->push(event) ) {
+        // Full, the consumer is the only one who can make room. A slot
+        // running on the loop makes room itself instead of waiting forever.
+        if( impl_->consumer.load(std::memory_order_relaxed) == std::this_thread::get_id() ) {
+            processEvents(1);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    impl_->wake();
+}
+
+bool EventLoop::tryPost(Event& event) {
+    if( !impl_->push(event) ) {
+        return false;
+    }
+    impl_->wake();
+    return true;
+}
+
+std::size_t EventLoop::processEvents(std::size_t max) {
+    const std::thread::id previous = impl_->consumer.exchange(std::this_thread::get_id(), std::memory_order_relaxed);
+    std::size_t processed = 0;
+    Event event;
+    while( processed < max && impl_->pop(event) ) {
+        OBJECTSLOTS_TRACE_SCOPE("event", this);
+        event();
+        event = nullptr;
+        ++processed;
+    }
+    impl_->consumer.store(previous, std::memory_order_relaxed);
+    return processed;
+}
+
+void EventLoop::run() {
+    for( ;; ) {
+        processEvents();
+        std::unique_lock<std::mutex> lock(impl_->idleMutex);
+        impl_->sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        impl_->idle.wait(lock, [this]() {
+            return !impl_->empty() || impl_->stop.load(std::memory_order_relaxed);
+        });
+        impl_->sleeping.store(false, std::memory_order_relaxed);
+        if( impl_->empty() && impl_->stop.load(std::memory_order_relaxed) ) {
+            // The next run() starts over.
+            impl_->stop.store(false, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void EventLoop::quit() {
+    std::lock_guard<std::mutex> lock(impl_->idleMutex);
+    impl_->stop.store(true, std::memory_order_relaxed);
+    impl_->idle.notify_all();
+}
+
+std::size_t EventLoop::capacity() const {
+    return impl_->mask + 1;
+}
+
+} // end namespace Slots
@@ -1,122 +1,1984 @@
 #include "ObjectSlots/ObjectSlots.hpp"
+#include "ObjectSlots/StaticObjectSlots.hpp"
 
-#include <map>
-#include <list>
+#include "SignalTable.hpp"
 
 #ifdef OBJECTSLOTS_THREAD_SAFE
 #include <mutex>
 #include <shared_mutex>
-#define READLOCK()  std::shared_lock<std::shared_mutex> lock(impl_->mutex)
-#define WRITELOCK() std::unique_lock<std::shared_mutex> lock(impl_->mutex)
+#include <thread>
+#ifndef OBJECTSLOTS_LOCK_FREE
+// Every shard of the signal table has a lock of its own, see impl::Shard.
+#define OBJECTSLOTS_SHARDED
+#endif
+#endif
+#ifdef OBJECTSLOTS_SHARDED
+// Writers lock the shards of the signals they change, then the tables
+// shared by all signals. Readers lock the shards they read.
+#define WRITELOCK(shards) impl::WriteLock lock(*impl_, shards)
+#define READLOCK(shards)  impl::ReadLock lock(*impl_, shards)
+#define TABLELOCK()       std::lock_guard<std::mutex> lock(impl_->tables)
+#elif defined(OBJECTSLOTS_THREAD_SAFE)
+#define WRITELOCK(shards) std::unique_lock<std::shared_mutex> lock(impl_->mutex)
+#define READLOCK(shards)  std::shared_lock<std::shared_mutex> lock(impl_->mutex)
+#define TABLELOCK()       std::unique_lock<std::shared_mutex> lock(impl_->mutex)
 #else
-#define READLOCK()
-#define WRITELOCK()
+#define WRITELOCK(shards)
+#define READLOCK(shards)
+#define TABLELOCK()
+#endif
+#ifdef OBJECTSLOTS_LOCK_FREE
+#include "Epoch.hpp"
+#endif
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_LOCK_FREE)
+// Removed slots may still be running, they are deleted later.
+#define OBJECTSLOTS_DEFERRED_RECLAIM
 #endif
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace ObjectSlots {
 
+namespace {
+
+/**
+ * @brief Constructs a `T` in memory allocated from `resource`.
+ */
+template<class T, class ... Params>
+T* create(std::pmr::memory_resource* resource, Params&& ... params) {
+    return ::new (resource->allocate(sizeof(T), alignof(T))) T(std::forward<Params>(params)...);
+}
+
+/**
+ * @brief Destroys a `T` made by `create()` and returns its memory to `resource`.
+ */
+template<class T>
+void dispose(std::pmr::memory_resource* resource, const T* object) {
+    object->~T();
+    resource->deallocate(const_cast<T*>(object), sizeof(T), alignof(T));
+}
+
+}
+
+/**
+ * @brief Every signal owns a channel holding its slot list. A channel keeps
+ *        its address while the table of signals changes, so a `Signal`
+ *        refers to its own channel directly. In lock-free builds the channel
+ *        holds an immutable snapshot of the list; writers publish a new
+ *        snapshot and retire the old one. Other builds keep the list emits
+ *        run apart from the one writers change, see `impl::plan()`.
+ */
+struct ObjectSlots::Channel {
+    using SlotList = std::pmr::vector<SlotStorage>;
+
+#ifdef OBJECTSLOTS_LOCK_FREE
+    Channel(std::pmr::memory_resource* resource, const void* signal) : slots(create<SlotList>(resource, resource)), signal(signal) { }
+    ~Channel() {
+        const SlotList* list = slots.load(std::memory_order_relaxed);
+        dispose(list->get_allocator().resource(), list);
+    }
+    std::atomic<const SlotList*> slots;
+#else
+    Channel(std::pmr::memory_resource* resource, const void* signal) : slots(resource), plan(resource), signal(signal) { }
+    SlotList slots;
+    /** @brief Bumped by every change of `slots`, under the write lock. */
+    std::uint64_t version = 0;
+    /** @brief The slots of `slots` that are still bound, in order, as emits run them. */
+    mutable SlotList plan;
+    /** @brief The number of slots at the front of `plan` that go to the urgent dispatcher. */
+    mutable std::size_t urgentSlots = 0;
+    /** @brief The version `plan` was built from. */
+    mutable std::atomic<std::uint64_t> planned{~std::uint64_t(0)};
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+    /** @brief Held while `plan` is built, emits of a signal may run on several threads. */
+    mutable std::atomic_flag planning = ATOMIC_FLAG_INIT;
+#endif
+#endif
+    /** @brief The key of the channel, traces report the signal by it. */
+    const void* signal;
+    /** @brief Set while a `Signal` refers to the channel, it is kept even without slots. */
+    bool pinned = false;
+#ifdef OBJECTSLOTS_STATS
+    mutable std::atomic<std::uint64_t> emits{0};
+#endif
+};
+
 struct ObjectSlots::impl {
-    using SlotList = std::vector<void*>;
-    using SignalMap = std::map<const void*, SlotList>;
-    using const_iterator = SignalMap::const_iterator;
-    using iterator = SignalMap::iterator;
+    using SlotList = Channel::SlotList;
+    using SignalMap = SignalTable<Channel*>;
+
+#ifdef OBJECTSLOTS_LOCK_FREE
+    impl(std::pmr::memory_resource* resource, std::size_t, const Capacity& capacity)
+        : resource(resource), Signals(create<SignalMap>(resource, resource)) {
+        const_cast<SignalMap*>(Signals.load(std::memory_order_relaxed))->reserve(capacity.signals);
+        retiredSnapshots.reserve(capacity.signals * capacity.slotsPerSignal + capacity.signals);
+        reserve(capacity);
+    }
+#else
+    impl(std::pmr::memory_resource* resource, std::size_t shards, const Capacity& capacity) : resource(resource) {
+#ifdef OBJECTSLOTS_SHARDED
+        while( shardCount < shards && shardCount < MaxShards ) {
+            shardCount *= 2;
+        }
+        if( shardCount > 1 ) {
+            padded = static_cast<PaddedShard*>(resource->allocate(shardCount * sizeof(PaddedShard), alignof(PaddedShard)));
+            for( std::size_t i = 0; i < shardCount; ++i ) {
+                ::new (static_cast<void*>(padded + i)) PaddedShard{ Shard(resource) };
+            }
+        }
+#else
+        static_cast<void>(shards);
+#endif
+        forShards(AllShards, [&capacity](Shard& shard) { shard.Signals.reserve(capacity.signals); });
+        reserve(capacity);
+    }
+#endif
+
+    std::pmr::memory_resource* const resource;
+
+    /**
+     * @brief Sizes the tables for `capacity`, so binding up to that many slots
+     *        does not grow them.
+     */
+    void reserve(const Capacity& capacity) {
+        const std::size_t count = capacity.signals * capacity.slotsPerSignal;
+        slotsPerSignal = capacity.slotsPerSignal;
+        connections.reserve(count);
+        freeConnections.reserve(count);
+        objects.reserve(count);
+        receivers.reserve(count);
+#ifdef OBJECTSLOTS_DEFERRED_RECLAIM
+        retired.reserve(count);
+#endif
+#ifdef OBJECTSLOTS_STATS
+        for( std::uint32_t index = 0; index < count; index += FirstChunk ) {
+            reserveCounters(index);
+        }
+#endif
+    }
+
+    /** @brief The capacity the slot array of a new channel starts with. */
+    std::size_t slotsPerSignal = 0;
+
+    /**
+     * @brief A set of shards, one bit each.
+     */
+    using ShardMask = std::uint32_t;
+    static constexpr ShardMask AllShards = ~ShardMask(0);
+    static constexpr std::size_t MaxShards = 32;
+    std::size_t shardCount = 1;
+
+#ifndef OBJECTSLOTS_LOCK_FREE
+    /**
+     * @brief A part of the signal table. In thread-safe builds each shard has
+     *        a lock of its own, so a writer only blocks the emits of the
+     *        signals in the shards it changes.
+     */
+    struct Shard {
+        explicit Shard(std::pmr::memory_resource* resource) : Signals(resource) { }
+#ifdef OBJECTSLOTS_THREAD_SAFE
+        std::shared_mutex mutex;
+#endif
+        SignalMap Signals;
+        /** @brief The number of empty slots left by unbinding connections. */
+        std::size_t tombstones = 0;
+    };
 
-    inline const_iterator begin() const { return Signals.begin(); }
-    inline const_iterator end() const { return Signals.end(); }
-    inline iterator find(void* signal) { return Signals.find(signal); }
+    /** @brief A shard on cache lines of its own, so locking one never invalidates another. */
+    struct alignas(64) PaddedShard {
+        Shard shard;
+    };
 
-    inline const_iterator cbegin() const { return Signals.cbegin(); }
-    inline const_iterator cend() const { return Signals.cend(); }
+    Shard& shard(std::size_t index) { return padded ? padded[index].shard : single; }
+    const Shard& shard(std::size_t index) const { return padded ? padded[index].shard : single; }
 
-    inline iterator begin() { return Signals.begin(); }
-    inline iterator end() { return Signals.end(); }
+    std::size_t shardIndex(const void* signal) const {
+        // The top bits of a Fibonacci hash, the signal table itself uses lower ones.
+        const std::uint64_t hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(signal)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(hash >> 59) & (shardCount - 1);
+    }
 
-    inline iterator erase(iterator it) { return Signals.erase(it); }
-    inline iterator erase(const_iterator it) { return Signals.erase(it); }
-    inline iterator erase(iterator first, iterator last) { return Signals.erase(first, last); }
+    Shard& shardOf(const void* signal) { return shard(shardIndex(signal)); }
+    const Shard& shardOf(const void* signal) const { return shard(shardIndex(signal)); }
 
-    inline SlotList& operator[](void* &signal ) { return Signals[signal]; }
-    inline SlotList& operator[](void* &&signal ) { return Signals[signal]; }
+    /**
+     * @brief Calls `f` with every shard in `shards`.
+     */
+    template<class F>
+    void forShards(ShardMask shards, F&& f) {
+        for( std::size_t i = 0; i < shardCount; ++i ) {
+            if( shards & (ShardMask(1) << i) ) {
+                f(shard(i));
+            }
+        }
+    }
+#endif
+
+    ShardMask maskOf(const void* signal) const {
+#ifdef OBJECTSLOTS_SHARDED
+        return ShardMask(1) << shardIndex(signal);
+#else
+        static_cast<void>(signal);
+        return AllShards;
+#endif
+    }
+
+    /**
+     * @brief One entry per connection handed out by `bind()`, so a handle
+     *        finds its slot directly. `position` is the slot's index in the
+     *        list of `channel`, the generation tells live handles from stale ones.
+     *        The connections of one object are linked through `previous` and `next`.
+     */
+    struct ConnectionRecord {
+        Channel* channel;
+        const void* object;
+        std::uint32_t generation;
+        std::uint32_t position;
+        std::uint32_t previous;
+        std::uint32_t next;
+    };
+    using Connections = std::pmr::vector<std::uint32_t>;
+    std::pmr::vector<ConnectionRecord> connections{resource};
+    Connections freeConnections{resource};
+
+    /** @brief Ends the list of connections of an object. */
+    static constexpr std::uint32_t None = ~std::uint32_t(0);
+
+    /**
+     * @brief The first connection of every object that has slots bound, so
+     *        unbinding an object only visits its own connections.
+     */
+    SignalTable<std::uint32_t> objects{resource};
+
+    /**
+     * @brief Calls `f` with every connection of `object`. `f` may release the one it is given.
+     */
+    template<class F>
+    void forConnections(const void* object, F&& f) {
+        const std::uint32_t* first = objects.find(object);
+        for( std::uint32_t index = first ? *first : None; index != None; ) {
+            const std::uint32_t next = connections[index].next;
+            f(index);
+            index = next;
+        }
+    }
+
+    /**
+     * @brief The receivers bound to this instance, told when it is destroyed.
+     */
+    SignalTable<Receiver*> receivers{resource};
+
+    /**
+     * @brief Returns the slots of a channel.
+     *        In lock-free builds the caller must be inside an `Epoch` critical section.
+     */
+    static const SlotList& slots(const Channel* channel) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        return *channel->slots.load(std::memory_order_acquire);
+#else
+        return channel->slots;
+#endif
+    }
+
+    /**
+     * @brief Returns the emit plan of a channel, the slots emits run. It is built
+     *        by the first emit after the slots changed, so emits never skip an
+     *        unbound slot and writers keep unbinding in constant time.
+     *        The caller must hold the read lock, which keeps the version as it is.
+     *        In lock-free builds the caller must be inside an `Epoch` critical section.
+     */
+    static const SlotList& plan(const Channel* channel) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        // Snapshots never hold unbound slots, they are their own plan.
+        return slots(channel);
+#else
+        if( channel->planned.load(std::memory_order_acquire) != channel->version ) {
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+            while( channel->planning.test_and_set(std::memory_order_acquire) ) {
+                std::this_thread::yield();
+            }
+#endif
+            if( channel->planned.load(std::memory_order_relaxed) != channel->version ) {
+                channel->plan.clear();
+                for( const SlotStorage& slot : channel->slots ) {
+                    if( !slot.empty() ) {
+                        channel->plan.push_back(slot);
+                    }
+                }
+                channel->urgentSlots = urgentCount(channel->plan);
+                channel->planned.store(channel->version, std::memory_order_release);
+            }
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+            channel->planning.clear(std::memory_order_release);
+#endif
+        }
+        return channel->plan;
+#endif
+    }
+
+    /**
+     * @brief Returns the number of urgent slots at the front of a list without unbound slots.
+     */
+    static std::size_t urgentCount(const SlotList& slots) {
+        std::size_t count = 0;
+        while( count < slots.size() && slots[count].priority() >= static_cast<std::int16_t>(Priority::Urgent) ) {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Returns the channel of a signal, or nullptr.
+     *        In lock-free builds the caller must be inside an `Epoch` critical section.
+     */
+    const Channel* find(const void* signal) const {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        Channel* const* channel = Signals.load(std::memory_order_acquire)->find(signal);
+#else
+        Channel* const* channel = shardOf(signal).Signals.find(signal);
+#endif
+        return channel ? *channel : nullptr;
+    }
+
+#ifdef OBJECTSLOTS_STATS
+    /**
+     * @brief Calls `f` with every signal and its channel.
+     *        The caller must hold the lock.
+     */
+    template<class F>
+    void forEach(F&& f) const {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        Signals.load(std::memory_order_acquire)->forEach(f);
+#else
+        for( std::size_t i = 0; i < shardCount; ++i ) {
+            shard(i).Signals.forEach(f);
+        }
+#endif
+    }
+
+    /**
+     * @brief The counters of one connection. They live as long as the
+     *        instance, so detached invocations may still update them
+     *        after the slot was unbound.
+     */
+    struct SlotCounters {
+        std::atomic<std::uint64_t> invocations{0};
+        std::atomic<std::uint64_t> nanoseconds{0};
+        std::atomic<std::uint64_t> latency[LatencyHistogram::Buckets] = {};
+
+        void reset() {
+            invocations.store(0, std::memory_order_relaxed);
+            nanoseconds.store(0, std::memory_order_relaxed);
+            for( auto& bucket : latency ) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * @brief Returns the counters of a connection. Chunk `c` holds the
+     *        connections from `(2^c - 1) * FirstChunk` on and is twice the size
+     *        of the one before, so counters never move and emits find them
+     *        without a lock.
+     */
+    SlotCounters& counters(std::uint32_t index) const {
+        const std::uint64_t position = std::uint64_t(index) + FirstChunk;
+        const std::size_t chunk = chunkOf(position);
+        SlotCounters* counters = chunks[chunk].load(std::memory_order_acquire);
+        return counters[position - (std::uint64_t(FirstChunk) << chunk)];
+    }
+
+    static std::size_t chunkOf(std::uint64_t position) {
+        std::size_t chunk = 0;
+        for( position /= FirstChunk; position > 1; position >>= 1 ) {
+            ++chunk;
+        }
+        return chunk;
+    }
+
+    /**
+     * @brief Makes sure the counters of a new connection exist and are zero.
+     *        The caller must hold the write lock.
+     */
+    void resetCounters(std::uint32_t index) {
+        reserveCounters(index);
+        counters(index).reset();
+    }
+
+    /**
+     * @brief Makes sure the chunk holding the counters of `index` exists.
+     *        The caller must hold the write lock.
+     */
+    void reserveCounters(std::uint32_t index) {
+        const std::size_t chunk = chunkOf(std::uint64_t(index) + FirstChunk);
+        if( !chunks[chunk].load(std::memory_order_relaxed) ) {
+            const std::size_t count = std::size_t(FirstChunk) << chunk;
+            SlotCounters* counters = static_cast<SlotCounters*>(resource->allocate(count * sizeof(SlotCounters), alignof(SlotCounters)));
+            std::uninitialized_value_construct_n(counters, count);
+            chunks[chunk].store(counters, std::memory_order_release);
+        }
+    }
+
+    static constexpr std::uint32_t FirstChunk = 64;
+    std::atomic<SlotCounters*> chunks[32] = {};
+#endif
+
+    /**
+     * @brief Returns the channel of a signal, creating it if needed.
+     *        The caller must hold the write lock.
+     */
+    Channel* channel(const void* signal) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        const SignalMap* table = Signals.load(std::memory_order_relaxed);
+        if( Channel* const* found = table->find(signal) ) {
+            return *found;
+        }
+        Channel* channel = create<Channel>(resource, resource, signal);
+        SignalMap* grown = create<SignalMap>(resource, *table);
+        grown->insert(signal, std::move(channel));
+        Signals.store(grown, std::memory_order_release);
+        retire(table);
+        return channel;
+#else
+        SignalMap& Signals = shardOf(signal).Signals;
+        if( Channel* const* found = Signals.find(signal) ) {
+            return *found;
+        }
+        Channel* channel = create<Channel>(resource, resource, signal);
+        channel->slots.reserve(slotsPerSignal);
+        channel->plan.reserve(slotsPerSignal);
+        return Signals.insert(signal, std::move(channel));
+#endif
+    }
+
+    /**
+     * @brief Lets `f` modify the slot list of one channel.
+     *        The caller must hold the write lock.
+     */
+    template<class F>
+    void update(Channel* channel, F&& f) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        const SlotList* current = channel->slots.load(std::memory_order_relaxed);
+        SlotList* next = create<SlotList>(resource, *current, resource);
+        f(*next);
+        channel->slots.store(next, std::memory_order_release);
+        retire(current);
+#else
+        f(channel->slots);
+        ++channel->version;
+#endif
+    }
+
+    /**
+     * @brief Lets `f` modify the slot list of every signal in `shards` and drops
+     *        the signals left without slots. `f` returns true if it changed the list.
+     *        The caller must hold the write lock of these shards.
+     */
+    template<class F>
+    void updateAll(F&& f, ShardMask shards = AllShards) {
+        bool emptied = false;
+#ifdef OBJECTSLOTS_LOCK_FREE
+        static_cast<void>(shards);
+        const SignalMap* table = Signals.load(std::memory_order_relaxed);
+        SlotList scratch(resource);
+        table->forEach([&](const void*, Channel* channel) {
+            const SlotList* current = channel->slots.load(std::memory_order_relaxed);
+            if( current->empty() ) {
+                // Left behind by unbinding a connection.
+                emptied |= !channel->pinned;
+                return;
+            }
+            scratch.assign(current->begin(), current->end());
+            if( f(scratch) ) {
+                channel->slots.store(create<SlotList>(resource, scratch, resource), std::memory_order_release);
+                retire(current);
+                emptied |= scratch.empty() && !channel->pinned;
+            }
+        });
+        if( emptied ) {
+            SignalMap* shrunk = create<SignalMap>(resource, *table);
+            shrunk->eraseIf(&impl::unused);
+            Signals.store(shrunk, std::memory_order_release);
+            table->forEach([this](const void*, Channel* channel) {
+                if( unused(channel) ) {
+                    retire(channel);
+                }
+            });
+            retire(table);
+        }
+#else
+        forShards(shards, [&](Shard& shard) {
+            emptied = false;
+            shard.Signals.forEach([&](const void*, Channel* channel) {
+                if( f(channel->slots) ) {
+                    ++channel->version;
+                    emptied |= unused(channel);
+                }
+            });
+            if( emptied ) {
+                shard.Signals.eraseIf([this](Channel* channel) {
+                    if( !unused(channel) ) {
+                        return false;
+                    }
+                    dispose(resource, channel);
+                    return true;
+                });
+            }
+        });
+#endif
+    }
+
+    /**
+     * @brief True for a channel without slots that no `Signal` refers to.
+     */
+    static bool unused(const Channel* channel) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        return !channel->pinned && channel->slots.load(std::memory_order_relaxed)->empty();
+#else
+        return !channel->pinned && channel->slots.empty();
+#endif
+    }
+
+    /**
+     * @brief Removes a signal, its slots and its channel.
+     *        The caller must hold the write lock.
+     */
+    void erase(const void* signal) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        const SignalMap* table = Signals.load(std::memory_order_relaxed);
+        Channel* const* found = table->find(signal);
+#else
+        SignalMap& Signals = shardOf(signal).Signals;
+        Channel* const* found = Signals.find(signal);
+#endif
+        if( !found ) {
+            return;
+        }
+        Channel* channel = *found;
+        for( const SlotStorage& slot : slots(channel) ) {
+            if( !slot.empty() ) {
+                release(slot.connection());
+                retire(slot);
+            }
+        }
+#ifdef OBJECTSLOTS_LOCK_FREE
+        SignalMap* shrunk = create<SignalMap>(resource, *table);
+        shrunk->erase(signal);
+        Signals.store(shrunk, std::memory_order_release);
+        retire(channel);
+        retire(table);
+#else
+        Signals.erase(signal);
+        dispose(resource, channel);
+#endif
+    }
+
+    /**
+     * @brief Marks the `position` of a connection whose slot is not stored yet.
+     */
+    static constexpr std::uint32_t Reserved = ~std::uint32_t(0);
+
+    /**
+     * @brief Takes a free entry of the connection table, to be connected later.
+     */
+    std::uint32_t reserve() {
+        std::uint32_t index;
+        if( !freeConnections.empty() ) {
+            index = freeConnections.back();
+            freeConnections.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(connections.size());
+            connections.push_back({ nullptr, nullptr, 1, 0, None, None });
+        }
+        connections[index].position = Reserved;
+        return index;
+    }
+
+    /**
+     * @brief Takes a free entry of the connection table for a slot of `channel`.
+     */
+    std::uint32_t connect(Channel* channel, const void* object) {
+        const std::uint32_t index = reserve();
+        connect(index, channel, object);
+        return index;
+    }
+
+    /**
+     * @brief Fills a reserved entry of the connection table for a slot of `channel`.
+     */
+    void connect(std::uint32_t index, Channel* channel, const void* object) {
+        connections[index].channel = channel;
+        connections[index].object = object;
+#ifdef OBJECTSLOTS_STATS
+        resetCounters(index);
+#endif
+        if( object ) {
+            ConnectionRecord& record = connections[index];
+            record.previous = None;
+            if( std::uint32_t* first = objects.find(object) ) {
+                record.next = *first;
+                connections[*first].previous = index;
+                *first = index;
+            } else {
+                record.next = None;
+                objects.insert(object, std::uint32_t(index));
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the entry of a live connection, or nullptr for a stale handle.
+     */
+    const ConnectionRecord* record(std::uint32_t index, std::uint32_t generation) const {
+        if( index >= connections.size() ) {
+            return nullptr;
+        }
+        const ConnectionRecord& record = connections[index];
+        return record.channel != nullptr && record.generation == generation ? &record : nullptr;
+    }
+
+    /**
+     * @brief True for a handle whose slot is still to be stored, see `Change`.
+     */
+    bool reserved(std::uint32_t index, std::uint32_t generation) const {
+        return index < connections.size() && connections[index].channel == nullptr &&
+            connections[index].generation == generation && connections[index].position == Reserved;
+    }
+
+    /**
+     * @brief Marks the `position` of a reserved connection that was unbound before its slot was stored.
+     */
+    static constexpr std::uint32_t Cancelled = Reserved - 1;
+
+    /**
+     * @brief Unbinds a connection whose slot is still to be stored, so it
+     *        never is. Returns false if the handle is not such a connection.
+     *        The caller must hold the table lock.
+     */
+    bool cancel(std::uint32_t index, std::uint32_t generation) {
+        if( !reserved(index, generation) ) {
+            return false;
+        }
+        connections[index].position = Cancelled;
+        return true;
+    }
+
+    /**
+     * @brief Stores a slot for `signal` in the reserved connection `index`, behind
+     *        every other slot of at least its priority.
+     *        The caller must hold the write lock of the signal's shard.
+     */
+    void store(const void* signal, const SlotStorage& slot, std::uint32_t index, std::int16_t level) {
+        Channel* channel = this->channel(signal);
+#ifndef OBJECTSLOTS_LOCK_FREE
+        // Emits build the plan in place, they never allocate.
+        channel->plan.reserve(channel->slots.size() + 1);
+#endif
+        connect(index, channel, slot.object());
+        update(channel, [&](SlotList& slots) {
+#ifndef OBJECTSLOTS_LOCK_FREE
+            if( slots.size() == slots.capacity() ) {
+                // Reuses the room of unbound connections before growing the array.
+                Shard& shard = shardOf(signal);
+                shard.tombstones -= std::min(shard.tombstones, squeeze(slots));
+            }
+#endif
+            // Without priorities the position is always the end.
+            std::size_t position = slots.size();
+            while( position > 0 && (slots[position - 1].empty() || slots[position - 1].priority() < level) ) {
+                --position;
+            }
+            SlotStorage& stored = *slots.insert(slots.begin() + position, slot);
+            stored.setConnection(index);
+            stored.setPriority(level);
+            reindex(slots, position);
+        });
+    }
+
+    /**
+     * @brief Frees the entry of a removed slot. Handles to it become stale.
+     */
+    void release(std::uint32_t index) {
+        ConnectionRecord& record = connections[index];
+        if( record.object ) {
+            if( record.next != None ) {
+                connections[record.next].previous = record.previous;
+            }
+            if( record.previous != None ) {
+                connections[record.previous].next = record.next;
+            } else if( record.next != None ) {
+                *objects.find(record.object) = record.next;
+            } else {
+                objects.erase(record.object);
+            }
+            record.object = nullptr;
+        }
+        record.channel = nullptr;
+        record.position = 0;
+        ++record.generation;
+        freeConnections.push_back(index);
+    }
+
+    /**
+     * @brief Returns the slot of a live connection.
+     *        The caller must hold the write lock.
+     */
+    const SlotStorage& slot(std::uint32_t index) const {
+        const ConnectionRecord& record = connections[index];
+        return slots(record.channel)[record.position];
+    }
+
+    /**
+     * @brief Updates the positions of the slots of a list from `first` on.
+     */
+    void reindex(const SlotList& slots, std::size_t first = 0) {
+        for( std::size_t i = first; i < slots.size(); ++i ) {
+            if( !slots[i].empty() ) {
+                connections[slots[i].connection()].position = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the slot of a live connection and returns it for retirement.
+     *        The caller must hold the write lock.
+     */
+    SlotStorage disconnect(std::uint32_t index) {
+        const ConnectionRecord record = connections[index];
+        release(index);
+#ifdef OBJECTSLOTS_LOCK_FREE
+        // Readers only see immutable snapshots, the slot is erased from a copy.
+        SlotStorage removed;
+        update(record.channel, [&](SlotList& slots) {
+            removed = slots[record.position];
+            slots.erase(slots.begin() + record.position);
+            reindex(slots, record.position);
+        });
+        return removed;
+#else
+        // The slot is emptied in place, so no other slot moves. The arrays
+        // are compacted once they hold more empty slots than bound ones.
+        SlotStorage& slot = record.channel->slots[record.position];
+        SlotStorage removed = slot;
+        slot = SlotStorage{};
+        ++record.channel->version;
+        Shard& shard = shardOf(record.channel->signal);
+        if( ++shard.tombstones > MinTombstones && shard.tombstones > connections.size() - freeConnections.size() ) {
+            compact(maskOf(record.channel->signal));
+        }
+        return removed;
+#endif
+    }
+
+#ifndef OBJECTSLOTS_LOCK_FREE
+    /**
+     * @brief Drops the empty slots from every array in `shards`.
+     *        The caller must hold the write lock of these shards.
+     */
+    void compact(ShardMask shards) {
+        updateAll([this](SlotList& slots) { return squeeze(slots) > 0; }, shards);
+        forShards(shards, [](Shard& shard) { shard.tombstones = 0; });
+    }
+
+    /**
+     * @brief Drops the empty slots of one array, returns how many there were.
+     */
+    std::size_t squeeze(SlotList& slots) {
+        const std::size_t size = slots.size();
+        slots.erase(std::remove_if(slots.begin(), slots.end(), [](const SlotStorage& slot) { return slot.empty(); }), slots.end());
+        if( slots.size() != size ) {
+            reindex(slots);
+        }
+        return size - slots.size();
+    }
+
+    static constexpr std::size_t MinTombstones = 16;
+#endif
 
     ~impl() {
-        for( auto it = Signals.begin(); it != Signals.end(); ++it ) {
-            for( auto i = it->second.begin(); i != it->second.end(); ++i ) {
-                delete reinterpret_cast<Base<void>*>(*i);
+#ifdef OBJECTSLOTS_DEFERRED_RECLAIM
+        for( auto& item : retired ) {
+            item.slot.destroy();
+        }
+#endif
+#ifdef OBJECTSLOTS_LOCK_FREE
+        for( auto& item : retiredSnapshots ) {
+            item.deleter(resource, item.object);
+        }
+        const SignalMap* table = Signals.load(std::memory_order_relaxed);
+        table->forEach([this](const void*, Channel* channel) { destroyChannel(channel); });
+        dispose(resource, table);
+#else
+        for( std::size_t i = 0; i < shardCount; ++i ) {
+            shard(i).Signals.forEach([this](const void*, Channel* channel) { destroyChannel(channel); });
+        }
+        for( const Change& change : changes ) {
+            if( change.kind == Change::Kind::Bind ) {
+                SlotStorage(change.slot).destroy();
+            }
+        }
+        if( padded ) {
+            for( std::size_t i = 0; i < shardCount; ++i ) {
+                padded[i].~PaddedShard();
             }
+            resource->deallocate(padded, shardCount * sizeof(PaddedShard), alignof(PaddedShard));
         }
+#endif
+        for( const Change& change : staged ) {
+            if( change.kind == Change::Kind::Bind ) {
+                SlotStorage(change.slot).destroy();
+            }
+        }
+#ifdef OBJECTSLOTS_STATS
+        for( std::size_t chunk = 0; chunk < 32; ++chunk ) {
+            if( SlotCounters* counters = chunks[chunk].load(std::memory_order_relaxed) ) {
+                const std::size_t count = std::size_t(FirstChunk) << chunk;
+                std::destroy_n(counters, count);
+                resource->deallocate(counters, count * sizeof(SlotCounters), alignof(SlotCounters));
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief A bind or unbind recorded to be applied later: made by a slot
+     *        while its emitter dispatches, since lists cannot change under a
+     *        running emit, or staged by a `Transaction`. Binds reserve their
+     *        connection at once, so the handle they return works right away.
+     */
+    struct Change {
+        enum class Kind { Bind, Unbind, Remove };
+        Kind kind;
+        const void* signal;
+        SlotStorage slot;
+        std::int16_t priority;
+        std::uint32_t index;
+        std::uint32_t generation;
+        void* object;
+        void* callback;
+    };
+
+    /**
+     * @brief Returns where a change made now is recorded instead of being
+     *        applied: the transaction the calling thread has open, or the
+     *        changes to apply after the running emit. Nullptr to apply it now.
+     */
+    std::pmr::vector<Change>* pending(const ObjectSlots* owner) {
+        if( staging() ) {
+            return &staged;
+        }
+#ifndef OBJECTSLOTS_LOCK_FREE
+        if( dispatching(owner) ) {
+            return &changes;
+        }
+#else
+        static_cast<void>(owner);
+#endif
+        return nullptr;
     }
 
+    /**
+     * @brief Records a change in the list `pending()` returned.
+     *        The caller must hold the table lock.
+     */
+    void postpone(std::pmr::vector<Change>* list, const Change& change) {
+#ifndef OBJECTSLOTS_LOCK_FREE
+        if( list == &changes ) {
+            defer(change);
+            return;
+        }
+#endif
+        list->push_back(change);
+    }
+
+    /**
+     * @brief Frees the connection of a recorded bind that was unbound before
+     *        it was stored. Returns false if the bind is still to be stored.
+     *        The caller must hold the table lock.
+     */
+    bool dropCancelled(const Change& change) {
+        if( connections[change.index].position != Cancelled ) {
+            return false;
+        }
+        release(change.index);
+        SlotStorage(change.slot).destroy();
+        return true;
+    }
+
+    /**
+     * @brief True while the calling thread has a transaction open on this instance.
+     */
+    bool staging() const {
 #ifdef OBJECTSLOTS_THREAD_SAFE
+        return stagingThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+#else
+        return transactions > 0;
+#endif
+    }
+
+    /**
+     * @brief Returns the recorded bind of a reserved connection, or nullptr
+     *        if it is not in a list this thread can reach.
+     *        The caller must hold the table lock.
+     */
+    Change* recorded(std::uint32_t index, std::uint32_t generation) {
+        auto find = [index, generation](std::pmr::vector<Change>& list) -> Change* {
+            for( Change& change : list ) {
+                if( change.kind == Change::Kind::Bind && change.index == index && change.generation == generation ) {
+                    return &change;
+                }
+            }
+            return nullptr;
+        };
+        if( Change* change = find(staged) ) {
+            return change;
+        }
+#ifndef OBJECTSLOTS_LOCK_FREE
+        return find(changes);
+#else
+        return nullptr;
+#endif
+    }
+
+    /**
+     * @brief Drops the staged binds that unbinding `object` and `callback`
+     *        removes, as `ObjectSlots::slotRemove()` matches them.
+     *        The caller must hold the table lock.
+     */
+    void dropStaged(const void* object, const void* callback) {
+        staged.erase(std::remove_if(staged.begin(), staged.end(), [&](const Change& change) {
+            if( change.kind != Change::Kind::Bind ) {
+                return false;
+            }
+            const bool matches = object
+                ? change.slot.object() == object && (!callback || change.slot.callback() == callback)
+                : change.slot.callback() == callback;
+            if( matches ) {
+                release(change.index);
+                SlotStorage(change.slot).destroy();
+            }
+            return matches;
+        }), staged.end());
+    }
+
+    /**
+     * @brief Applies the changes of a transaction. Unbinds come first, they
+     *        only refer to slots stored before it. Then the binds of every
+     *        signal are merged into its slot array in one pass.
+     *        The caller must hold the write lock of every shard.
+     */
+    void commit(const std::pmr::vector<Change>& changes) {
+        std::pmr::vector<const Change*> binds(resource);
+        binds.reserve(changes.size());
+        for( const Change& change : changes ) {
+            if( change.kind == Change::Kind::Unbind ) {
+                if( record(change.index, change.generation) ) {
+                    retire(disconnect(change.index));
+                }
+            } else if( !dropCancelled(change) ) {
+                binds.push_back(&change);
+            }
+        }
+        // Grouped by signal, highest priority first, equal ones in the order they were made.
+        std::sort(binds.begin(), binds.end(), [](const Change* a, const Change* b) {
+            if( a->signal != b->signal ) {
+                return std::less<const void*>()(a->signal, b->signal);
+            }
+            if( a->priority != b->priority ) {
+                return a->priority > b->priority;
+            }
+            return a < b;
+        });
+        objects.reserve(objects.size() + binds.size());
+#ifdef OBJECTSLOTS_LOCK_FREE
+        createChannels(binds);
+#endif
+        for( auto first = binds.begin(); first != binds.end(); ) {
+            const void* signal = (*first)->signal;
+            const auto last = std::find_if(first, binds.end(), [signal](const Change* change) { return change->signal != signal; });
+            merge(signal, first, last);
+            first = last;
+        }
+    }
+
+    /**
+     * @brief Stores the binds `[first, last)` of one signal, sorted as
+     *        `commit()` leaves them, each behind every slot of at least its
+     *        priority. The array grows once, to its final size.
+     *        The caller must hold the write lock of the signal's shard.
+     */
+    template<class Iterator>
+    void merge(const void* signal, Iterator first, Iterator last) {
+        Channel* channel = this->channel(signal);
+        const std::size_t count = static_cast<std::size_t>(last - first);
+        for( Iterator i = first; i != last; ++i ) {
+            connect((*i)->index, channel, (*i)->slot.object());
+        }
+        update(channel, [&](SlotList& slots) {
+#ifndef OBJECTSLOTS_LOCK_FREE
+            Shard& shard = shardOf(signal);
+            shard.tombstones -= std::min(shard.tombstones, squeeze(slots));
+            channel->plan.reserve(slots.size() + count);
+#endif
+            std::size_t old = slots.size();
+            slots.reserve(old + count);
+            slots.resize(old + count);
+            // From the back, so every slot moves at most once.
+            std::size_t position = slots.size();
+            for( Iterator i = last; i != first; ) {
+                const Change& change = **--i;
+                while( old > 0 && slots[old - 1].priority() < change.priority ) {
+                    slots[--position] = slots[--old];
+                }
+                SlotStorage& stored = slots[--position];
+                stored = change.slot;
+                stored.setConnection(change.index);
+                stored.setPriority(change.priority);
+            }
+            reindex(slots, position);
+        });
+    }
+
+#ifdef OBJECTSLOTS_LOCK_FREE
+    /**
+     * @brief Creates the channels `binds` are missing in one copy of the signal table.
+     *        The caller must hold the write lock.
+     */
+    void createChannels(const std::pmr::vector<const Change*>& binds) {
+        const SignalMap* table = Signals.load(std::memory_order_relaxed);
+        SignalMap* grown = nullptr;
+        for( const Change* change : binds ) {
+            if( table->find(change->signal) || (grown && grown->find(change->signal)) ) {
+                continue;
+            }
+            if( !grown ) {
+                grown = create<SignalMap>(resource, *table);
+            }
+            grown->insert(change->signal, create<Channel>(resource, resource, change->signal));
+        }
+        if( grown ) {
+            Signals.store(grown, std::memory_order_release);
+            retire(table);
+        }
+    }
+#endif
+
+    /** @brief The changes of the open transaction, only its thread touches them. */
+    std::pmr::vector<Change> staged{resource};
+    /** @brief The number of transactions open on the staging thread, they nest. */
+    std::size_t transactions = 0;
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    /** @brief Held by the thread that has a transaction open. */
+    std::mutex transaction;
+    std::atomic<std::thread::id> stagingThread{};
+#endif
+
+#ifndef OBJECTSLOTS_LOCK_FREE
+    /**
+     * @brief Records a change to apply after the outermost emit.
+     *        The caller must hold the table lock.
+     */
+    void defer(const Change& change) {
+        changes.push_back(change);
+#ifdef OBJECTSLOTS_SHARDED
+        deferred.store(true, std::memory_order_release);
+#endif
+    }
+
+    /**
+     * @brief True while the calling thread runs slots of `owner`, whose
+     *        lists must then stay as they are.
+     */
+    bool dispatching(const ObjectSlots* owner) const {
+#ifdef OBJECTSLOTS_SHARDED
+        return std::find(dispatchingThread.begin(), dispatchingThread.end(), owner) != dispatchingThread.end();
+#else
+        static_cast<void>(owner);
+        return depth > 0;
+#endif
+    }
+
+    /** @brief True if there are changes to apply, see `Change`. */
+    bool changed() const {
+#ifdef OBJECTSLOTS_SHARDED
+        return deferred.load(std::memory_order_acquire);
+#else
+        return !changes.empty();
+#endif
+    }
+
+    std::pmr::vector<Change> changes{resource};
+#ifdef OBJECTSLOTS_SHARDED
+    std::atomic<bool> deferred{false};
+
+    /**
+     * @brief The emitters whose slots the calling thread runs, innermost last.
+     *        Workers running slots of an emit whose lock another thread holds
+     *        are on it as well.
+     */
+    static thread_local std::vector<const ObjectSlots*> dispatchingThread;
+#else
+    /** @brief The number of emits running, builds without thread safety have one thread. */
+    std::size_t depth = 0;
+#endif
+#endif
+
+    void destroyChannel(Channel* channel) {
+        for( SlotStorage slot : slots(channel) ) {
+            slot.destroy();
+        }
+        dispose(resource, channel);
+    }
+
+#ifdef OBJECTSLOTS_SHARDED
+    /**
+     * @brief Guards the connection table, the object index, the receivers
+     *        and the retired slots. Taken after the shard locks.
+     */
+    std::mutex tables;
+
+    /**
+     * @brief Locks `shards` exclusively. Like `std::lock()` it never blocks on a
+     *        shard while holding another, so it cannot deadlock with an emit
+     *        that already holds one shard and emits a signal of another.
+     */
+    void lockShards(ShardMask shards) {
+        shards &= ShardMask(-1) >> (MaxShards - shardCount);
+        std::size_t first = 0;
+        while( !(shards & (ShardMask(1) << first)) ) {
+            ++first;
+        }
+        for( ;; ) {
+            shard(first).mutex.lock();
+            std::size_t failed = MaxShards;
+            for( std::size_t i = 0; i < shardCount; ++i ) {
+                if( i == first || !(shards & (ShardMask(1) << i)) ) {
+                    continue;
+                }
+                if( !shard(i).mutex.try_lock() ) {
+                    failed = i;
+                    break;
+                }
+            }
+            if( failed == MaxShards ) {
+                return;
+            }
+            for( std::size_t i = 0; i < failed; ++i ) {
+                if( i != first && (shards & (ShardMask(1) << i)) ) {
+                    shard(i).mutex.unlock();
+                }
+            }
+            shard(first).mutex.unlock();
+            std::this_thread::yield();
+            // Waits for the busy shard next time round.
+            first = failed;
+        }
+    }
+
+    void unlockShards(ShardMask shards) {
+        forShards(shards, [](Shard& shard) { shard.mutex.unlock(); });
+    }
+
+    class WriteLock {
+    public:
+        WriteLock(impl& owner, ShardMask shards) : owner_(owner), shards_(shards) {
+            owner_.lockShards(shards_);
+            owner_.tables.lock();
+        }
+        ~WriteLock() {
+            owner_.tables.unlock();
+            owner_.unlockShards(shards_);
+        }
+        WriteLock(const WriteLock&) = delete;
+        WriteLock& operator=(const WriteLock&) = delete;
+    private:
+        impl& owner_;
+        const ShardMask shards_;
+    };
+
+    class ReadLock {
+    public:
+        ReadLock(impl& owner, ShardMask shards) : owner_(owner), shards_(shards) {
+            owner_.forShards(shards_, [](Shard& shard) { shard.mutex.lock_shared(); });
+        }
+        ~ReadLock() {
+            owner_.forShards(shards_, [](Shard& shard) { shard.mutex.unlock_shared(); });
+        }
+        ReadLock(const ReadLock&) = delete;
+        ReadLock& operator=(const ReadLock&) = delete;
+    private:
+        impl& owner_;
+        const ShardMask shards_;
+    };
+#elif defined(OBJECTSLOTS_THREAD_SAFE)
     mutable std::shared_mutex mutex;
 #endif
 
+    /**
+     * @brief Returns the shard of a live connection, or no shard for a stale handle.
+     *        Builds without shard locks always return every shard.
+     */
+    ShardMask shardsOf(std::uint32_t index, std::uint32_t generation) {
+#ifdef OBJECTSLOTS_SHARDED
+        std::lock_guard<std::mutex> lock(tables);
+        const ConnectionRecord* found = record(index, generation);
+        return found ? maskOf(found->channel->signal) : 0;
+#else
+        static_cast<void>(index);
+        static_cast<void>(generation);
+        return AllShards;
+#endif
+    }
+
+    /**
+     * @brief Returns the shards of the connections of an object.
+     *        Builds without shard locks always return every shard.
+     */
+    ShardMask shardsOf(const void* object) {
+#ifdef OBJECTSLOTS_SHARDED
+        std::lock_guard<std::mutex> lock(tables);
+        ShardMask shards = 0;
+        forConnections(object, [&](std::uint32_t index) {
+            shards |= maskOf(connections[index].channel->signal);
+        });
+        return shards;
+#else
+        static_cast<void>(object);
+        return AllShards;
+#endif
+    }
+
+    /**
+     * @brief Deletes a removed slot, or keeps it until no emit can still be running it.
+     *        The slot must already be unlinked from every published list.
+     *        The caller must hold the write lock.
+     */
+    void retire(SlotStorage slot) {
+        if( !slot.owning() ) {
+            return;
+        }
+#ifdef OBJECTSLOTS_DEFERRED_RECLAIM
+        slot.disconnect();
+        Retired item{ slot, 0 };
+#ifdef OBJECTSLOTS_LOCK_FREE
+        item.epoch = Epoch::tag();
+#endif
+        retired.emplace_back(item);
+#else
+        slot.destroy();
+#endif
+    }
+
+#ifdef OBJECTSLOTS_LOCK_FREE
+    /**
+     * @brief Deletes an unlinked snapshot once no emit can still read it.
+     *        Snapshots are retired here rather than to `Epoch`, so the ones
+     *        still pending are freed with this instance, while its memory
+     *        resource is guaranteed to be alive.
+     *        The caller must hold the write lock.
+     */
+    template<class T>
+    void retire(const T* object) {
+        retiredSnapshots.push_back({ const_cast<T*>(object), [](std::pmr::memory_resource* resource, void* p) {
+            dispose(resource, static_cast<T*>(p));
+        }, Epoch::tag() });
+    }
+#endif
+
+    /**
+     * @brief Deletes the retired slots and snapshots nothing can be using anymore.
+     *        The caller must hold the write lock.
+     */
+    void reclaim() {
+#ifdef OBJECTSLOTS_LOCK_FREE
+        if( !retiredSnapshots.empty() ) {
+            const std::uint64_t oldest = Epoch::oldest();
+            auto keep = retiredSnapshots.begin();
+            for( auto& item : retiredSnapshots ) {
+                if( item.epoch >= oldest ) {
+                    *keep++ = item;
+                    continue;
+                }
+                item.deleter(resource, item.object);
+            }
+            retiredSnapshots.erase(keep, retiredSnapshots.end());
+        }
+#endif
+#ifdef OBJECTSLOTS_DEFERRED_RECLAIM
+        if( retired.empty() ) {
+            return;
+        }
+#ifdef OBJECTSLOTS_THREADED
+        if( !detached.done() ) {
+            return;
+        }
+#endif
+#ifdef OBJECTSLOTS_LOCK_FREE
+        const std::uint64_t oldest = Epoch::oldest();
+#endif
+        auto keep = retired.begin();
+        for( auto& item : retired ) {
+#ifdef OBJECTSLOTS_LOCK_FREE
+            if( item.epoch >= oldest ) {
+                *keep++ = item;
+                continue;
+            }
+#endif
+            item.slot.destroy();
+        }
+        retired.erase(keep, retired.end());
+#endif
+    }
+
+#ifdef OBJECTSLOTS_THREADED
+    std::shared_ptr<Dispatcher> dispatcher = Dispatcher::global();
+#ifdef OBJECTSLOTS_LOCK_FREE
+    // Emits read the dispatcher without taking the lock.
+    std::atomic<Dispatcher*> active{dispatcher.get()};
+    std::atomic<Dispatcher*> activeUrgent{nullptr};
+#endif
+    std::shared_ptr<Dispatcher> urgent;
+    std::atomic<EmitPolicy> policy{EmitPolicy::Wait};
+    std::atomic<std::size_t> grain{64};
+    TaskGroup detached;
+#endif
+
 private:
-    SignalMap Signals;
+#ifdef OBJECTSLOTS_DEFERRED_RECLAIM
+    struct Retired {
+        SlotStorage slot;
+        std::uint64_t epoch;
+    };
+    std::pmr::vector<Retired> retired{resource};
+#endif
+#ifdef OBJECTSLOTS_LOCK_FREE
+    struct RetiredSnapshot {
+        void* object;
+        void (*deleter)(std::pmr::memory_resource*, void*);
+        std::uint64_t epoch;
+    };
+    std::pmr::vector<RetiredSnapshot> retiredSnapshots{resource};
+    std::atomic<const SignalMap*> Signals;
+#else
+    Shard single{resource};
+    PaddedShard* padded = nullptr;
+#endif
 };
 
-ObjectSlots::ObjectSlots() : impl_(new impl()) { }
+#ifdef OBJECTSLOTS_SHARDED
+thread_local std::vector<const ObjectSlots*> ObjectSlots::impl::dispatchingThread;
+#endif
+
+ObjectSlots::ObjectSlots() : ObjectSlots(std::pmr::get_default_resource()) { }
+
+ObjectSlots::ObjectSlots(std::pmr::memory_resource* resource) : ObjectSlots(Shards{1}, resource) { }
+
+ObjectSlots::ObjectSlots(Shards shards, std::pmr::memory_resource* resource)
+    : impl_(create<impl>(resource, resource, shards.count, Capacity{0, 0})) { }
+
+ObjectSlots::ObjectSlots(Capacity capacity, std::pmr::memory_resource* resource)
+    : impl_(create<impl>(resource, resource, 1, capacity)) {
+    // What StaticObjectSlots sizes its arena by.
+    static_assert(sizeof(impl) <= StaticLayout::Instance, "StaticLayout::Instance is too small");
+    static_assert(sizeof(Channel) <= StaticLayout::Channel, "StaticLayout::Channel is too small");
+    static_assert(sizeof(impl::ConnectionRecord) <= StaticLayout::Connection, "StaticLayout::Connection is too small");
+    static_assert(sizeof(impl::SignalMap::Entry) <= StaticLayout::Entry, "StaticLayout::Entry is too small");
+    static_assert(sizeof(SignalTable<std::uint32_t>::Entry) <= StaticLayout::Entry, "StaticLayout::Entry is too small");
+#ifdef OBJECTSLOTS_STATS
+    static_assert(sizeof(impl::SlotCounters) <= StaticLayout::Counters, "StaticLayout::Counters is too small");
+#endif
+}
 
 ObjectSlots::~ObjectSlots() {
-    WRITELOCK();
-    delete impl_;
+#ifdef OBJECTSLOTS_THREADED
+    impl_->dispatcher->wait(impl_->detached);
+#endif
+    {
+        // Waits for emits that are still running; the lock must be
+        // released before the mutex is destroyed with impl_.
+        WRITELOCK(impl::AllShards);
+        impl_->receivers.forEach([this](const void*, Receiver* receiver) {
+            receiver->forget(this);
+        });
+    }
+    dispose(impl_->resource, impl_);
 }
 
-void* ObjectSlots::getSlot(void* signal, int index) {
-    const auto& slots = impl_->find(signal);
-    if( slots != impl_->end() && index < slots->second.size() ) {
-        return slots->second[index];
+std::pmr::memory_resource* ObjectSlots::resource() const {
+    return impl_->resource;
+}
+
+std::size_t ObjectSlots::shardCount() const {
+    return impl_->shardCount;
+}
+
+ObjectSlots::SlotSpan ObjectSlots::getSlots(void* signal) {
+    if( const Channel* channel = impl_->find(signal) ) {
+        return channelSlots(channel);
     }
-    return nullptr;
+    SlotSpan none{};
+    none.signal = signal;
+    return none;
 }
 
-void ObjectSlots::slotStore(void* signal, void* slot) {
-    WRITELOCK();
-    (*impl_)[signal].emplace_back(slot);
+ObjectSlots::SlotSpan ObjectSlots::channelSlots(const Channel* channel) {
+    const auto& slots = impl::plan(channel);
+    SlotSpan span{};
+    span.data = slots.data();
+    span.size = slots.size();
+#ifdef OBJECTSLOTS_LOCK_FREE
+    span.urgentSlots = impl::urgentCount(slots);
+#else
+    span.urgentSlots = channel->urgentSlots;
+#endif
+    span.signal = channel->signal;
+#ifdef OBJECTSLOTS_STATS
+    span.channel = channel;
+#endif
+    return span;
+}
+
+#ifdef OBJECTSLOTS_STATS
+void ObjectSlots::recordEmit(const Channel* channel, std::size_t count) {
+    // Signals without any slot have no channel to count in.
+    if( channel ) {
+        channel->emits.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void ObjectSlots::recordInvoke(const SlotStorage& slot, std::size_t count, std::uint64_t nanoseconds) {
+    impl::SlotCounters& counters = impl_->counters(slot.connection());
+    counters.invocations.fetch_add(count, std::memory_order_relaxed);
+    counters.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    counters.latency[LatencyHistogram::bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<SignalStats> ObjectSlots::stats() const {
+    std::vector<SignalStats> result;
+    READLOCK(impl::AllShards);
+    impl_->forEach([&](const void* signal, const Channel* channel) {
+        SignalStats stats{ signal, channel->emits.load(std::memory_order_relaxed), {} };
+        for( const SlotStorage& slot : impl::slots(channel) ) {
+            if( slot.empty() ) {
+                continue;
+            }
+            const impl::SlotCounters& counters = impl_->counters(slot.connection());
+            SlotStats entry{ slot.object(), slot.callback(),
+                counters.invocations.load(std::memory_order_relaxed),
+                counters.nanoseconds.load(std::memory_order_relaxed), {} };
+            for( std::size_t i = 0; i < LatencyHistogram::Buckets; ++i ) {
+                entry.latency.counts[i] = counters.latency[i].load(std::memory_order_relaxed);
+            }
+            stats.slots.push_back(entry);
+        }
+        result.push_back(std::move(stats));
+    });
+    return result;
+}
+
+void ObjectSlots::resetStats() {
+    READLOCK(impl::AllShards);
+    impl_->forEach([&](const void*, Channel* channel) {
+        channel->emits.store(0, std::memory_order_relaxed);
+        for( const SlotStorage& slot : impl::slots(channel) ) {
+            if( !slot.empty() ) {
+                impl_->counters(slot.connection()).reset();
+            }
+        }
+    });
+}
+#endif
+
+ObjectSlots::Channel* ObjectSlots::attachSignal(const void* signal) {
+    WRITELOCK(impl_->maskOf(signal));
+    Channel* channel = impl_->channel(signal);
+    channel->pinned = true;
+    return channel;
+}
+
+void ObjectSlots::detachSignal(const void* signal) {
+    WRITELOCK(impl_->maskOf(signal));
+    impl_->reclaim();
+    impl_->erase(signal);
+}
+
+Connection ObjectSlots::slotStore(void* signal, const SlotStorage& slot, Priority priority) {
+    const std::int16_t level = static_cast<std::int16_t>(priority);
+    if( std::pmr::vector<impl::Change>* pending = impl_->pending(this) ) {
+        TABLELOCK();
+        const std::uint32_t index = impl_->reserve();
+        const std::uint32_t generation = impl_->connections[index].generation;
+        impl_->postpone(pending, { impl::Change::Kind::Bind, signal, slot, level, index, generation, nullptr, nullptr });
+        return Connection(this, index, generation);
+    }
+    WRITELOCK(impl_->maskOf(signal));
+    impl_->reclaim();
+    const std::uint32_t index = impl_->reserve();
+    impl_->store(signal, slot, index, level);
+    return Connection(this, index, impl_->connections[index].generation);
+}
+
+void ObjectSlots::unbind(const Connection& connection) {
+    if( connection.owner_ != this ) {
+        return;
+    }
+    if( std::pmr::vector<impl::Change>* pending = impl_->pending(this) ) {
+        TABLELOCK();
+        if( !impl_->cancel(connection.index_, connection.generation_) && impl_->record(connection.index_, connection.generation_) ) {
+            impl_->postpone(pending, { impl::Change::Kind::Unbind, nullptr, SlotStorage{}, 0, connection.index_, connection.generation_, nullptr, nullptr });
+        }
+        return;
+    }
+    const impl::ShardMask shards = impl_->shardsOf(connection.index_, connection.generation_);
+    if( !shards ) {
+        // Its slot may still be to be stored, see impl::Change.
+        TABLELOCK();
+        impl_->cancel(connection.index_, connection.generation_);
+        return;
+    }
+    WRITELOCK(shards);
+    impl_->reclaim();
+    // Checked again, it may have been unbound in between.
+    if( impl_->record(connection.index_, connection.generation_) ) {
+        impl_->retire(impl_->disconnect(connection.index_));
+    } else {
+        impl_->cancel(connection.index_, connection.generation_);
+    }
+}
+
+bool ObjectSlots::connected(const Connection& connection) const {
+    if( connection.owner_ != this ) {
+        return false;
+    }
+    TABLELOCK();
+    if( impl_->reserved(connection.index_, connection.generation_) ) {
+        return true;
+    }
+    return impl_->record(connection.index_, connection.generation_) != nullptr;
+}
+
+#ifdef OBJECTSLOTS_THREADED
+bool ObjectSlots::setAffinity(const Connection& connection, std::size_t group) {
+    if( connection.owner_ != this ) {
+        return false;
+    }
+    const std::uint8_t affinity = group == Dispatcher::CallerGroup ? SlotStorage::CallerWorkers
+        : group < SlotStorage::CallerWorkers ? static_cast<std::uint8_t>(group)
+        : SlotStorage::AnyWorkers;
+    {
+        // A bind still to be stored takes the affinity along.
+        TABLELOCK();
+        if( impl_->reserved(connection.index_, connection.generation_) ) {
+            impl::Change* change = impl_->recorded(connection.index_, connection.generation_);
+            if( change ) {
+                change->slot.setAffinity(affinity);
+            }
+            return change != nullptr;
+        }
+    }
+    const impl::ShardMask shards = impl_->shardsOf(connection.index_, connection.generation_);
+    if( !shards ) {
+        return false;
+    }
+    WRITELOCK(shards);
+    impl_->reclaim();
+    const impl::ConnectionRecord* record = impl_->record(connection.index_, connection.generation_);
+    if( !record ) {
+        return false;
+    }
+    const std::uint32_t position = record->position;
+    impl_->update(record->channel, [position, affinity](impl::SlotList& slots) {
+        slots[position].setAffinity(affinity);
+    });
+    return true;
+}
+#endif
+
+bool Connection::connected() const {
+    return owner_ && owner_->connected(*this);
+}
+
+void Connection::disconnect() {
+    if( owner_ ) {
+        owner_->unbind(*this);
+        *this = Connection();
+    }
 }
 
 void ObjectSlots::slotRemove(void* object, void* slot) {
-    WRITELOCK();
     // mode:
     // 0 : no object or method (should never happen)
     // 1 : slot but no object
     // 2 : object but no slot
     // 3 : object and slot
     const int mode = (object!=nullptr)<<1 | (slot!=nullptr);
-    for( auto it = impl_->begin(); it != impl_->end(); ) {
-        for( auto i = it->second.begin(); i != it->second.end();) {
-            Base<void> *SlotOrMethod = reinterpret_cast<Base<void>*>(*i);
+    if( impl_->staging() ) {
+        // The object may be gone once this returns, its staged binds are dropped too.
+        TABLELOCK();
+        impl_->dropStaged(object, slot);
+    }
+#ifndef OBJECTSLOTS_LOCK_FREE
+    if( impl_->dispatching(this) ) {
+        TABLELOCK();
+        impl_->defer({ impl::Change::Kind::Remove, nullptr, SlotStorage{}, 0, 0, 0, object, slot });
+        return;
+    }
+#endif
+    if( mode & 2 ) {
+        // Only the shards of the object's own connections are locked. It may
+        // be bound to another shard meanwhile, those are done the next round.
+        for( ;; ) {
+            const impl::ShardMask shards = impl_->shardsOf(object);
+            if( !shards ) {
+                return;
+            }
+            WRITELOCK(shards);
+            impl_->reclaim();
+            bool missed = false;
+            impl_->forConnections(object, [&](std::uint32_t connection) {
+                if( !(impl_->maskOf(impl_->connections[connection].channel->signal) & shards) ) {
+                    missed = true;
+                } else if( mode == 2 || impl_->slot(connection).callback() == slot ) {
+                    impl_->retire(impl_->disconnect(connection));
+                }
+            });
+            if( !missed ) {
+                return;
+            }
+        }
+    }
+    WRITELOCK(impl::AllShards);
+    impl_->reclaim();
+    std::pmr::vector<SlotStorage> removed(impl_->resource);
+    impl_->updateAll([&](impl::SlotList& slots) {
+        bool changed = false;
+        for( auto i = slots.begin(); i != slots.end();) {
+            const SlotStorage& SlotOrMethod = *i;
+            if( SlotOrMethod.empty() ) {
+                // Left by an unbound connection, compacted on the way.
+                i = slots.erase(i);
+                changed = true;
+                continue;
+            }
             bool remove = false;
             switch (mode)
             {
-            case 1: remove = (SlotOrMethod->callback() == slot); break;
-            case 2: remove = (SlotOrMethod->object() == object); break;
-            case 3: remove = (SlotOrMethod->callback() == slot && SlotOrMethod->object() == object); break;
+            case 1: remove = (SlotOrMethod.callback() == slot); break;
             default: break;
             }
 
             if(remove) {
-                i = it->second.erase(i);
-                delete SlotOrMethod;
+                removed.emplace_back(SlotOrMethod);
+                impl_->release(SlotOrMethod.connection());
+                i = slots.erase(i);
+                changed = true;
                 continue;
             }
             ++i;
         }
-        if ( it->second.empty() ) {
-            it = impl_->erase(it);
-            continue;
+        if( changed ) {
+            impl_->reindex(slots);
         }
-        ++it;
+        return changed;
+    });
+#ifndef OBJECTSLOTS_LOCK_FREE
+    impl_->forShards(impl::AllShards, [](impl::Shard& shard) { shard.tombstones = 0; });
+#endif
+    // Only retired once the lists without them are published.
+    for( auto SlotOrMethod : removed ) {
+        impl_->retire(SlotOrMethod);
+    }
+}
+
+void ObjectSlots::track(Receiver* receiver, const void* object) {
+    {
+        TABLELOCK();
+        impl_->receivers[receiver] = receiver;
     }
+    receiver->link(this, object);
 }
 
+void ObjectSlots::untrack(Receiver* receiver, const void* object) {
+    {
+        TABLELOCK();
+        impl_->receivers.erase(receiver);
+    }
+    slotRemove(const_cast<void*>(object), nullptr);
+}
+
+void ObjectSlots::beginTransaction() {
 #ifdef OBJECTSLOTS_THREAD_SAFE
-ObjectSlots::LockP ObjectSlots::acquireLock() {
-    return new std::shared_lock<std::shared_mutex>(impl_->mutex);
+    if( !impl_->staging() ) {
+        impl_->transaction.lock();
+        impl_->stagingThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+#endif
+    ++impl_->transactions;
+}
+
+void ObjectSlots::endTransaction() {
+    if( --impl_->transactions > 0 ) {
+        return;
+    }
+    std::pmr::vector<impl::Change> changes(impl_->resource);
+    {
+        // setAffinity() may look for a staged bind.
+        TABLELOCK();
+        changes.swap(impl_->staged);
+    }
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    impl_->stagingThread.store(std::thread::id(), std::memory_order_relaxed);
+    impl_->transaction.unlock();
+#endif
+    if( changes.empty() ) {
+        return;
+    }
+#ifndef OBJECTSLOTS_LOCK_FREE
+    if( impl_->dispatching(this) ) {
+        // Committed by a slot, the lists change once the emit returned.
+        TABLELOCK();
+        for( const impl::Change& change : changes ) {
+            impl_->defer(change);
+        }
+        return;
+    }
+#endif
+    WRITELOCK(impl::AllShards);
+    impl_->reclaim();
+    impl_->commit(changes);
+}
+
+Transaction::Transaction(ObjectSlots& emitter) : emitter_(&emitter) {
+    emitter_->beginTransaction();
+}
+
+void Transaction::commit() {
+    if( ObjectSlots* emitter = emitter_ ) {
+        emitter_ = nullptr;
+        emitter->endTransaction();
+    }
+}
+
+void Receiver::unbindAll() {
+    std::vector<Link> links;
+    {
+#ifdef OBJECTSLOTS_THREAD_SAFE
+        std::lock_guard<std::mutex> lock(mutex_);
+#endif
+        links.swap(links_);
+    }
+    for( const Link& link : links ) {
+        link.emitter->untrack(this, link.object);
+    }
+}
+
+void Receiver::link(ObjectSlots* emitter, const void* object) {
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    for( const Link& link : links_ ) {
+        if( link.emitter == emitter && link.object == object ) {
+            return;
+        }
+    }
+    links_.push_back({ emitter, object });
+}
+
+void Receiver::forget(ObjectSlots* emitter) {
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    links_.erase(std::remove_if(links_.begin(), links_.end(), [emitter](const Link& link) {
+        return link.emitter == emitter;
+    }), links_.end());
+}
+
+bool Liveness::alive() const {
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+    return (calls_.load(std::memory_order_acquire) & Expired) == 0;
+#else
+    return alive_;
+#endif
+}
+
+void Liveness::expire() {
+#if defined(OBJECTSLOTS_THREADED) || defined(OBJECTSLOTS_THREAD_SAFE)
+    calls_.fetch_or(Expired, std::memory_order_acq_rel);
+    // A slot may expire its own object, the calls of this thread are not waited for.
+    std::uint32_t own = 0;
+    for( const Scope* scope = Scope::innermost_; scope; scope = scope->outer_ ) {
+        own += &scope->liveness_ == this;
+    }
+    while( (calls_.load(std::memory_order_acquire) & ~Expired) > own ) {
+        std::this_thread::yield();
+    }
+#else
+    alive_ = false;
+#endif
+}
+
+void TrackedState::attach(ObjectSlots* owner, const Connection& connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    owner_ = owner;
+    connection_ = connection;
+}
+
+void TrackedState::expired() {
+    ObjectSlots* owner;
+    Connection connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Later calls until the unbind is applied only skip the slot.
+        owner = owner_;
+        connection = connection_;
+        owner_ = nullptr;
+    }
+    if( owner ) {
+        // Made from inside an emit, it is applied once the emit returns.
+        owner->unbind(connection);
+    }
 }
-void ObjectSlots::releaseLock(ObjectSlots::LockP lock) {
-    delete reinterpret_cast<std::shared_lock<std::shared_mutex>*>(lock);
+
+#ifdef OBJECTSLOTS_THREADED
+void ObjectSlots::setDispatcher(std::shared_ptr<Dispatcher> dispatcher) {
+    // Emits of every signal read it.
+    WRITELOCK(impl::AllShards);
+    if( !dispatcher ) {
+        dispatcher = Dispatcher::global();
+    }
+#ifdef OBJECTSLOTS_LOCK_FREE
+    // Running emits may still use the old dispatcher.
+    Epoch::retire(new std::shared_ptr<Dispatcher>(std::move(impl_->dispatcher)));
+    impl_->active.store(dispatcher.get(), std::memory_order_release);
+#endif
+    impl_->dispatcher = std::move(dispatcher);
+}
+
+std::shared_ptr<Dispatcher> ObjectSlots::dispatcher() const {
+    TABLELOCK();
+    return impl_->dispatcher;
+}
+
+void ObjectSlots::setUrgentDispatcher(std::shared_ptr<Dispatcher> dispatcher) {
+    WRITELOCK(impl::AllShards);
+#ifdef OBJECTSLOTS_LOCK_FREE
+    Epoch::retire(new std::shared_ptr<Dispatcher>(std::move(impl_->urgent)));
+    impl_->activeUrgent.store(dispatcher.get(), std::memory_order_release);
+#endif
+    impl_->urgent = std::move(dispatcher);
+}
+
+std::shared_ptr<Dispatcher> ObjectSlots::urgentDispatcher() const {
+    TABLELOCK();
+    return impl_->urgent;
+}
+
+void ObjectSlots::setEmitPolicy(EmitPolicy policy) {
+    impl_->policy.store(policy, std::memory_order_relaxed);
+}
+
+ObjectSlots::EmitPolicy ObjectSlots::emitPolicy() const {
+    return impl_->policy.load(std::memory_order_relaxed);
+}
+
+void ObjectSlots::setGrainSize(std::size_t grain) {
+    impl_->grain.store(grain == 0 ? 1 : grain, std::memory_order_relaxed);
+}
+
+std::size_t ObjectSlots::grainSize() const {
+    return impl_->grain.load(std::memory_order_relaxed);
+}
+
+ObjectSlots::Lanes ObjectSlots::currentDispatcher(EmitPolicy& policy) {
+    policy = impl_->policy.load(std::memory_order_relaxed);
+#ifdef OBJECTSLOTS_LOCK_FREE
+    return { impl_->active.load(std::memory_order_acquire), impl_->activeUrgent.load(std::memory_order_acquire) };
+#else
+    return { impl_->dispatcher.get(), impl_->urgent.get() };
+#endif
+}
+
+TaskGroup& ObjectSlots::detachedTasks() {
+    return impl_->detached;
+}
+#endif
+
+#ifdef OBJECTSLOTS_LOCK_FREE
+void ObjectSlots::acquireLock(const void*) {
+    Epoch::enter();
+}
+void ObjectSlots::releaseLock(const void*) {
+    Epoch::leave();
+}
+#else
+void ObjectSlots::acquireLock(const void* signal) {
+#ifdef OBJECTSLOTS_SHARDED
+    impl_->shardOf(signal).mutex.lock_shared();
+    impl::dispatchingThread.push_back(this);
+#else
+    static_cast<void>(signal);
+    ++impl_->depth;
+#endif
+}
+void ObjectSlots::releaseLock(const void* signal) {
+#ifdef OBJECTSLOTS_SHARDED
+    impl::dispatchingThread.pop_back();
+    impl_->shardOf(signal).mutex.unlock_shared();
+#else
+    static_cast<void>(signal);
+    --impl_->depth;
+#endif
+    if( impl_->changed() && !impl_->dispatching(this) ) {
+        applyChanges();
+    }
+}
+
+#ifdef OBJECTSLOTS_SHARDED
+void ObjectSlots::enterDispatch() {
+    impl::dispatchingThread.push_back(this);
+}
+void ObjectSlots::leaveDispatch() {
+    impl::dispatchingThread.pop_back();
+}
+#endif
+
+void ObjectSlots::applyChanges() {
+    std::pmr::vector<impl::Change> changes(impl_->resource);
+    {
+        TABLELOCK();
+        changes.swap(impl_->changes);
+#ifdef OBJECTSLOTS_SHARDED
+        impl_->deferred.store(false, std::memory_order_relaxed);
+#endif
+    }
+    // In the order they were made, so a slot bound and unbound again is gone.
+    for( const impl::Change& change : changes ) {
+        switch( change.kind ) {
+        case impl::Change::Kind::Bind: {
+            WRITELOCK(impl_->maskOf(change.signal));
+            impl_->reclaim();
+            if( !impl_->dropCancelled(change) ) {
+                impl_->store(change.signal, change.slot, change.index, change.priority);
+            }
+            break;
+        }
+        case impl::Change::Kind::Unbind:
+            unbind(Connection(this, change.index, change.generation));
+            break;
+        case impl::Change::Kind::Remove:
+            slotRemove(change.object, change.callback);
+            break;
+        }
+    }
 }
 #endif
 
-} // end namespace Slots
\ No newline at end of file
+} // end namespace Slots
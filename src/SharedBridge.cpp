@@ -0,0 +1,277 @@
+#include "ObjectSlots/SharedBridge.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OBJECTSLOTS_SHARED_MEMORY
+#endif
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace ObjectSlots {
+
+namespace {
+
+constexpr std::uint64_t Magic = 0x4f62536c6f745247; // "ObSlotRG"
+constexpr std::uint32_t Version = 1;
+
+/** @brief The states of a reader entry. */
+enum : std::uint32_t { Free = 0, Joining = 1, Joined = 2 };
+
+#ifdef __linux__
+void futexWait(std::atomic<std::uint32_t>* word, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+    const auto ns = timeout.count();
+    timespec relative{ static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000) };
+    // Not FUTEX_PRIVATE_FLAG, the word is shared with other processes.
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<std::uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+}
+
+/**
+ * @brief The start of the shared-memory object, the elements follow it.
+ *        Every field processes write on its own cache line.
+ */
+struct SharedRing::Header {
+    struct alignas(64) ReaderEntry {
+        std::atomic<std::uint32_t> state;
+        /** @brief The sequence number of the next element the reader consumes. */
+        std::atomic<std::uint64_t> tail;
+    };
+
+    /** @brief Stored last by `create()`, `open()` refuses a ring without it. */
+    std::atomic<std::uint64_t> magic;
+    std::uint32_t version;
+    std::uint32_t elementSize;
+    std::uint64_t capacity;
+
+    alignas(64) std::atomic<std::uint64_t> head;
+    std::atomic<std::uint64_t> dropped;
+
+    /** @brief Bumped to wake the readers, they sleep on it. */
+    alignas(64) std::atomic<std::uint32_t> wakeups;
+    std::atomic<std::uint32_t> sleepers;
+
+    ReaderEntry readers[MaxReaders];
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+    "shared rings need address-free atomics");
+
+SharedRing::SharedRing(const std::string& name, void* region, std::size_t bytes, bool owner)
+    : name_(name), header_(static_cast<Header*>(region)), elements_(static_cast<unsigned char*>(region) + sizeof(Header)),
+      bytes_(bytes), mask_(header_->capacity - 1), owner_(owner) {
+    static_assert(sizeof(Header) % 64 == 0, "elements start on a cache line");
+}
+
+std::unique_ptr<SharedRing> SharedRing::create(const std::string& name, std::size_t elementSize, std::size_t capacity) {
+#ifdef OBJECTSLOTS_SHARED_MEMORY
+    if( elementSize == 0 || elementSize > UINT32_MAX ) {
+        return nullptr;
+    }
+    std::size_t rounded = 1;
+    while( rounded < capacity ) {
+        rounded *= 2;
+    }
+    const std::size_t bytes = sizeof(Header) + rounded * elementSize;
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if( fd < 0 ) {
+        return nullptr;
+    }
+    void* region = MAP_FAILED;
+    if( ftruncate(fd, static_cast<off_t>(bytes)) == 0 ) {
+        region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if( region == MAP_FAILED ) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    // The object is zero filled, the atomics start out zero and free.
+    Header* header = ::new (region) Header();
+    header->version = Version;
+    header->elementSize = static_cast<std::uint32_t>(elementSize);
+    header->capacity = rounded;
+    header->magic.store(Magic, std::memory_order_release);
+    return std::unique_ptr<SharedRing>(new SharedRing(name, region, bytes, true));
+#else
+    static_cast<void>(name);
+    static_cast<void>(elementSize);
+    static_cast<void>(capacity);
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<SharedRing> SharedRing::open(const std::string& name, std::size_t elementSize) {
+#ifdef OBJECTSLOTS_SHARED_MEMORY
+    const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if( fd < 0 ) {
+        return nullptr;
+    }
+    struct stat info;
+    void* region = MAP_FAILED;
+    std::size_t bytes = 0;
+    if( fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(Header) ) {
+        bytes = static_cast<std::size_t>(info.st_size);
+        region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if( region == MAP_FAILED ) {
+        return nullptr;
+    }
+    const Header* header = static_cast<const Header*>(region);
+    if( header->magic.load(std::memory_order_acquire) != Magic || header->version != Version ||
+        header->elementSize != elementSize || header->capacity == 0 ||
+        sizeof(Header) + header->capacity * elementSize != bytes ) {
+        munmap(region, bytes);
+        return nullptr;
+    }
+    return std::unique_ptr<SharedRing>(new SharedRing(name, region, bytes, false));
+#else
+    static_cast<void>(name);
+    static_cast<void>(elementSize);
+    return nullptr;
+#endif
+}
+
+SharedRing::~SharedRing() {
+#ifdef OBJECTSLOTS_SHARED_MEMORY
+    munmap(header_, bytes_);
+    if( owner_ ) {
+        // Processes that mapped it keep their mapping.
+        shm_unlink(name_.c_str());
+    }
+#endif
+}
+
+std::size_t SharedRing::elementSize() const {
+    return header_->elementSize;
+}
+
+std::size_t SharedRing::capacity() const {
+    return static_cast<std::size_t>(header_->capacity);
+}
+
+void* SharedRing::element(std::uint64_t sequence) const {
+    return elements_ + (sequence & mask_) * header_->elementSize;
+}
+
+std::uint64_t SharedRing::head() const {
+    return header_->head.load(std::memory_order_relaxed);
+}
+
+std::size_t SharedRing::writable() const {
+    const std::uint64_t head = header_->head.load(std::memory_order_relaxed);
+    std::uint64_t slowest = head;
+    for( const Header::ReaderEntry& reader : header_->readers ) {
+        // Pairs with the join in Reader::Reader(), see there.
+        if( reader.state.load() == Joined ) {
+            slowest = std::min(slowest, reader.tail.load(std::memory_order_acquire));
+        }
+    }
+    return static_cast<std::size_t>(header_->capacity - (head - slowest));
+}
+
+void SharedRing::publish(std::size_t count) {
+    header_->head.fetch_add(count);
+    // Pairs with the check in Reader::wait(), both sides use sequentially
+    // consistent operations so a wakeup is never lost.
+    if( header_->sleepers.load() > 0 ) {
+        header_->wakeups.fetch_add(1);
+#ifdef __linux__
+        futexWakeAll(&header_->wakeups);
+#endif
+    }
+}
+
+void SharedRing::drop(std::size_t count) {
+    header_->dropped.fetch_add(count, std::memory_order_relaxed);
+}
+
+std::uint64_t SharedRing::dropped() const {
+    return header_->dropped.load(std::memory_order_relaxed);
+}
+
+SharedRing::Reader::Reader(SharedRing& ring) : ring_(ring), index_(MaxReaders) {
+    Header* header = ring_.header_;
+    for( std::size_t i = 0; i < MaxReaders; ++i ) {
+        std::uint32_t state = Free;
+        if( header->readers[i].state.compare_exchange_strong(state, Joining) ) {
+            index_ = i;
+            break;
+        }
+    }
+    if( !valid() ) {
+        return;
+    }
+    Header::ReaderEntry& entry = header->readers[index_];
+    // A producer that misses the join may still write a whole ring from the
+    // head it saw. The head is read again once joined, so the reader starts
+    // at or after it, and never behind what the producer may overwrite.
+    entry.tail.store(header->head.load());
+    entry.state.store(Joined);
+    position_ = header->head.load();
+    entry.tail.store(position_);
+}
+
+SharedRing::Reader::~Reader() {
+    if( valid() ) {
+        ring_.header_->readers[index_].state.store(Free);
+    }
+}
+
+std::size_t SharedRing::Reader::available() const {
+    if( !valid() ) {
+        return 0;
+    }
+    return static_cast<std::size_t>(ring_.header_->head.load(std::memory_order_acquire) - position_);
+}
+
+void SharedRing::Reader::consume(std::size_t count) {
+    position_ += count;
+    // The elements were read, the producer may overwrite them.
+    ring_.header_->readers[index_].tail.store(position_, std::memory_order_release);
+}
+
+std::size_t SharedRing::Reader::wait(std::chrono::nanoseconds timeout) {
+    if( !valid() ) {
+        return 0;
+    }
+    Header* header = ring_.header_;
+    std::size_t count = available();
+    if( count > 0 || timeout <= std::chrono::nanoseconds::zero() ) {
+        return count;
+    }
+    header->sleepers.fetch_add(1);
+    const std::uint32_t seen = header->wakeups.load();
+    if( header->head.load() == position_ ) {
+#ifdef __linux__
+        futexWait(&header->wakeups, seen, timeout);
+#else
+        static_cast<void>(seen);
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while( header->head.load() == position_ && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+#endif
+    }
+    header->sleepers.fetch_sub(1);
+    return available();
+}
+
+} // end namespace Slots
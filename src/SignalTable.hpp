@@ -0,0 +1,211 @@
+#ifndef _OBJECTSLOTS_SIGNALTABLE_HPP_
+#define _OBJECTSLOTS_SIGNALTABLE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ObjectSlots {
+
+/**
+ * @brief `SignalTable` is a flat open-addressing hash table keyed by the
+ *        type-punned signal pointer.
+ *
+ * Entries live in one contiguous array and collisions are resolved by
+ * linear probing, so a lookup usually touches a single cache line.
+ * The table is kept at most half full and removal moves entries back
+ * into the gap instead of leaving tombstones. A null key marks an empty
+ * entry, which is fine since a signal pointer is never null.
+ *
+ * @tparam Value The value stored for every signal.
+ */
+template<class Value>
+class SignalTable {
+public:
+    struct Entry {
+        const void* key = nullptr;
+        Value value{};
+    };
+
+    explicit SignalTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries_(MinCapacity, Allocator(resource)) { }
+
+    /**
+     * @brief Copies the table, the copy allocates from the same resource.
+     */
+    SignalTable(const SignalTable& other) : entries_(other.entries_, other.entries_.get_allocator()), size_(other.size_) { }
+    SignalTable& operator=(const SignalTable&) = delete;
+
+    /**
+     * @brief Grows the table so `count` entries fit without rehashing.
+     */
+    void reserve(std::size_t count) {
+        std::size_t capacity = entries_.size();
+        while( count * 2 > capacity ) {
+            capacity *= 2;
+        }
+        if( capacity != entries_.size() ) {
+            rehash(capacity);
+        }
+    }
+
+    /**
+     * @brief Returns the value stored for a signal, or nullptr.
+     */
+    Value* find(const void* key) {
+        for( std::size_t i = home(key); ; i = next(i) ) {
+            Entry& entry = entries_[i];
+            if( entry.key == key ) {
+                return &entry.value;
+            }
+            if( entry.key == nullptr ) {
+                return nullptr;
+            }
+        }
+    }
+
+    const Value* find(const void* key) const {
+        return const_cast<SignalTable*>(this)->find(key);
+    }
+
+    /**
+     * @brief Returns the value stored for a signal, inserting a default one if needed.
+     */
+    Value& operator[](const void* key) {
+        if( Value* value = find(key) ) {
+            return *value;
+        }
+        return insert(key, Value{});
+    }
+
+    /**
+     * @brief Inserts the value for a signal that is not in the table yet.
+     *        The value is move constructed in place, so it keeps its allocator.
+     */
+    Value& insert(const void* key, Value&& value) {
+        if( (size_ + 1) * 2 > entries_.size() ) {
+            rehash(entries_.size() * 2);
+        }
+        ++size_;
+        return place(key, std::move(value))->value;
+    }
+
+    /**
+     * @brief Removes the entry of a key, returns false if there is none.
+     */
+    bool erase(const void* key) {
+        std::size_t gap = home(key);
+        while( entries_[gap].key != key ) {
+            if( entries_[gap].key == nullptr ) {
+                return false;
+            }
+            gap = next(gap);
+        }
+        // Moves every following entry of the cluster that may live in the
+        // gap back into it, so no probe sequence is broken.
+        const std::size_t mask = entries_.size() - 1;
+        for( std::size_t i = next(gap); entries_[i].key != nullptr; i = next(i) ) {
+            if( ((i - home(entries_[i].key)) & mask) >= ((i - gap) & mask) ) {
+                entries_[gap].key = entries_[i].key;
+                reset(entries_[gap].value, std::move(entries_[i].value));
+                gap = i;
+            }
+        }
+        entries_[gap].key = nullptr;
+        reset(entries_[gap].value, Value{});
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Removes the entries whose value satisfies the predicate.
+     */
+    template<class Pred>
+    void eraseIf(Pred pred) {
+        // Erasing moves later entries of a cluster back, into the index just
+        // visited, so it is visited again before moving on.
+        for( std::size_t i = 0; i < entries_.size(); ) {
+            Entry& entry = entries_[i];
+            if( entry.key != nullptr && pred(entry.value) ) {
+                erase(entry.key);
+                continue;
+            }
+            ++i;
+        }
+    }
+
+    /**
+     * @brief Calls `f(key, value)` for every entry.
+     */
+    template<class F>
+    void forEach(F&& f) {
+        for( Entry& entry : entries_ ) {
+            if( entry.key != nullptr ) {
+                f(entry.key, entry.value);
+            }
+        }
+    }
+
+    template<class F>
+    void forEach(F&& f) const {
+        for( const Entry& entry : entries_ ) {
+            if( entry.key != nullptr ) {
+                f(entry.key, entry.value);
+            }
+        }
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr std::size_t MinCapacity = 8;
+
+    std::size_t home(const void* key) const {
+        // Fibonacci hashing spreads the aligned pointer values over the table.
+        const std::uint64_t hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(hash >> 32) & (entries_.size() - 1);
+    }
+
+    std::size_t next(std::size_t index) const {
+        return (index + 1) & (entries_.size() - 1);
+    }
+
+    Entry* place(const void* key, Value&& value) {
+        std::size_t i = home(key);
+        while( entries_[i].key != nullptr ) {
+            i = next(i);
+        }
+        entries_[i].key = key;
+        reset(entries_[i].value, std::move(value));
+        return &entries_[i];
+    }
+
+    static void reset(Value& target, Value&& value) {
+        target.~Value();
+        ::new (static_cast<void*>(&target)) Value(std::move(value));
+    }
+
+    void rehash(std::size_t capacity) {
+        Entries old(capacity, entries_.get_allocator());
+        old.swap(entries_);
+        for( Entry& entry : old ) {
+            if( entry.key != nullptr ) {
+                place(entry.key, std::move(entry.value));
+            }
+        }
+    }
+
+    using Allocator = std::pmr::polymorphic_allocator<Entry>;
+    using Entries = std::vector<Entry, Allocator>;
+
+    Entries entries_;
+    std::size_t size_ = 0;
+};
+
+} // end namespace Slots
+
+#endif //_OBJECTSLOTS_SIGNALTABLE_HPP_
@@ -0,0 +1,63 @@
+#include "ObjectSlots/StaticObjectSlots.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace ObjectSlots {
+
+FixedArena::FixedArena(void* buffer, std::size_t bytes)
+    : buffer_(static_cast<unsigned char*>(buffer)), capacity_(bytes) { }
+
+std::size_t FixedArena::used() const {
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    return used_;
+}
+
+std::size_t FixedArena::sizeClass(std::size_t bytes, std::size_t alignment) {
+    std::size_t index = 0;
+    for( std::size_t size = MinBlock; size < std::max(bytes, alignment); size *= 2 ) {
+        ++index;
+    }
+    return index;
+}
+
+void* FixedArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if( alignment > MaxAlignment || bytes > capacity_ ) {
+        throw std::bad_alloc();
+    }
+    const std::size_t index = sizeClass(bytes, alignment);
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    if( FreeBlock* block = free_[index] ) {
+        free_[index] = block->next;
+        return block;
+    }
+    const std::size_t size = MinBlock << index;
+    // Carved blocks are aligned to their size, so any request of the class fits a freed one.
+    const std::size_t align = std::min(size, MaxAlignment);
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer_ + used_);
+    const std::size_t start = used_ + ((align - address % align) % align);
+    if( start > capacity_ || size > capacity_ - start ) {
+        throw std::bad_alloc();
+    }
+    used_ = start + size;
+    return buffer_ + start;
+}
+
+void FixedArena::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    const std::size_t index = sizeClass(bytes, alignment);
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    FreeBlock* block = ::new (p) FreeBlock{ free_[index] };
+    free_[index] = block;
+}
+
+bool FixedArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // end namespace Slots
@@ -0,0 +1,164 @@
+#include "ObjectSlots/Trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ObjectSlots {
+
+namespace {
+
+struct Event {
+    std::uint64_t nanoseconds;
+    const char* name;
+    const void* id;
+    char phase;
+};
+
+// One buffer per thread that ever recorded an event. Buffers are never
+// freed, a thread releases its buffer on exit for reuse by others.
+struct Buffer {
+    // Only contended while the trace is written or cleared.
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::uint64_t written = 0;
+    const char* name = nullptr;
+    std::size_t row = 0;
+    std::atomic<bool> used{true};
+    Buffer* next = nullptr;
+
+    void push(const Event& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if( events.size() < Trace::BufferSize ) {
+            events.push_back(event);
+        } else {
+            events[written % Trace::BufferSize] = event;
+        }
+        ++written;
+    }
+};
+
+struct Registry {
+    std::atomic<Buffer*> buffers{nullptr};
+    std::atomic<std::size_t> rows{0};
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+Buffer* acquireBuffer() {
+    Registry& r = registry();
+    for( Buffer* buffer = r.buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next ) {
+        bool expected = false;
+        if( !buffer->used.load(std::memory_order_relaxed) &&
+            buffer->used.compare_exchange_strong(expected, true, std::memory_order_acquire) ) {
+            return buffer;
+        }
+    }
+    Buffer* buffer = new Buffer();
+    // Sized once, so recording an event never allocates.
+    buffer->events.reserve(Trace::BufferSize);
+    buffer->row = r.rows.fetch_add(1, std::memory_order_relaxed) + 1;
+    buffer->next = r.buffers.load(std::memory_order_relaxed);
+    while( !r.buffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed) ) { }
+    return buffer;
+}
+
+struct ThreadBuffer {
+    ThreadBuffer() : buffer(acquireBuffer()) { }
+    ~ThreadBuffer() {
+        buffer->used.store(false, std::memory_order_release);
+    }
+    Buffer* buffer;
+};
+
+Buffer* threadBuffer() {
+    thread_local ThreadBuffer local;
+    return local.buffer;
+}
+
+std::uint64_t now() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry().start).count());
+}
+
+void writeString(std::ostream& out, const char* text) {
+    out << '"';
+    for( const char* c = text; *c; ++c ) {
+        if( *c == '"' || *c == '\\' ) {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+}
+
+void Trace::begin(const char* name, const void* id) {
+    threadBuffer()->push({ now(), name, id, 'B' });
+}
+
+void Trace::end(const char* name, const void* id) {
+    threadBuffer()->push({ now(), name, id, 'E' });
+}
+
+void Trace::nameThread(const char* name) {
+    Buffer* buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->name = name;
+}
+
+void Trace::writeChromeJson(std::ostream& out) {
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&out, &first]() {
+        if( !first ) {
+            out << ',';
+        }
+        first = false;
+        out << '\n';
+    };
+    for( Buffer* buffer = registry().buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next ) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if( buffer->name ) {
+            separate();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->row << ",\"args\":{\"name\":";
+            writeString(out, buffer->name);
+            out << "}}";
+        }
+        // Oldest first, a full buffer starts at the next slot to be overwritten.
+        const std::size_t size = buffer->events.size();
+        const std::size_t oldest = size < BufferSize ? 0 : buffer->written % BufferSize;
+        for( std::size_t i = 0; i < size; ++i ) {
+            const Event& event = buffer->events[(oldest + i) % size];
+            separate();
+            out << "{\"name\":";
+            writeString(out, event.name);
+            out << ",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->row
+                << ",\"ts\":" << event.nanoseconds / 1000 << '.';
+            const std::uint64_t fraction = event.nanoseconds % 1000;
+            out << char('0' + fraction / 100) << char('0' + fraction / 10 % 10) << char('0' + fraction % 10);
+            if( event.id ) {
+                out << ",\"args\":{\"id\":\"" << event.id << "\"}";
+            }
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+void Trace::clear() {
+    for( Buffer* buffer = registry().buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next ) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->written = 0;
+    }
+}
+
+} // end namespace Slots
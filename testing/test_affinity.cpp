@@ -0,0 +1,205 @@
+#include <iostream>
+
+#include <ObjectSlots/Dispatcher.hpp>
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+using ObjectSlots::Dispatcher;
+using ObjectSlots::WorkerGroup;
+
+std::vector<WorkerGroup> twoGroups() {
+    return { WorkerGroup{ "wide", {}, 3 }, WorkerGroup{ "narrow", {}, 1 } };
+}
+
+void testGroups() {
+    Dispatcher dispatcher(twoGroups());
+    CHECK( dispatcher.size() == 4 );
+    CHECK( dispatcher.groupCount() == 2 );
+    CHECK( dispatcher.group(1).name == "narrow" );
+    CHECK( dispatcher.group(1).workers == 1 );
+    CHECK( dispatcher.findGroup("wide") == 0 );
+    CHECK( dispatcher.findGroup("none") == Dispatcher::AnyGroup );
+    // No group has a CPU, other threads belong to none.
+    CHECK( dispatcher.currentGroup() == Dispatcher::AnyGroup );
+
+    Dispatcher plain(2);
+    CHECK( plain.groupCount() == 1 );
+    CHECK( plain.group(0).workers == 2 );
+
+    const std::vector<WorkerGroup> nodes = Dispatcher::nodes();
+    CHECK( !nodes.empty() );
+    for( const WorkerGroup& node : nodes ) {
+        CHECK( node.name.compare(0, 4, "node") == 0 );
+    }
+}
+
+void testGroupTasks() {
+    Dispatcher dispatcher(twoGroups());
+    std::mutex mutex;
+    std::vector<std::thread::id> threads;
+    std::atomic<int> wrongGroup{0};
+    ObjectSlots::TaskGroup group;
+    for( int i = 0; i < 200; ++i ) {
+        dispatcher.submit([&]() {
+            if( dispatcher.currentGroup() != 1 ) {
+                ++wrongGroup;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.push_back(std::this_thread::get_id());
+        }, &group, dispatcher.findGroup("narrow"));
+    }
+    dispatcher.wait(group);
+    CHECK( wrongGroup == 0 );
+    CHECK( threads.size() == 200 );
+    // The group has a single worker, the waiting thread leaves its tasks alone.
+    CHECK( std::all_of(threads.begin(), threads.end(), [&threads](std::thread::id id) { return id == threads.front(); }) );
+    CHECK( threads.front() != std::this_thread::get_id() );
+
+    // Tasks submitted from a worker to its own group stay in the group.
+    std::atomic<int> nested{0};
+    ObjectSlots::TaskGroup outer;
+    ObjectSlots::TaskGroup inner;
+    dispatcher.submit([&]() {
+        for( int i = 0; i < 10; ++i ) {
+            dispatcher.submit([&]() {
+                if( dispatcher.currentGroup() == 1 ) {
+                    ++nested;
+                }
+            }, &inner, Dispatcher::CallerGroup);
+        }
+    }, &outer, 1);
+    dispatcher.wait(outer);
+    dispatcher.wait(inner);
+    CHECK( nested == 10 );
+
+    // Indices past the groups run anywhere.
+    std::atomic<int> ran{0};
+    ObjectSlots::TaskGroup any;
+    for( int i = 0; i < 10; ++i ) {
+        dispatcher.submit([&ran]() { ++ran; }, &any, 7);
+    }
+    dispatcher.wait(any);
+    CHECK( ran == 10 );
+}
+
+#ifdef __linux__
+void testPinning() {
+    // The CPUs of the first node the process may use, every worker stays on them.
+    const WorkerGroup node = Dispatcher::nodes().front();
+    if( node.cpus.empty() ) {
+        return;
+    }
+    Dispatcher dispatcher({ WorkerGroup{ node.name, node.cpus, 2 } });
+    CHECK( dispatcher.currentGroup() == 0 || dispatcher.currentGroup() == Dispatcher::AnyGroup );
+    std::atomic<int> outside{0};
+    ObjectSlots::TaskGroup group;
+    for( int i = 0; i < 50; ++i ) {
+        dispatcher.submit([&node, &outside]() {
+            const int cpu = sched_getcpu();
+            if( std::find(node.cpus.begin(), node.cpus.end(), static_cast<unsigned>(cpu)) == node.cpus.end() ) {
+                ++outside;
+            }
+        }, &group, 0);
+    }
+    dispatcher.wait(group);
+    CHECK( outside == 0 );
+}
+#endif
+
+#ifdef OBJECTSLOTS_THREADED
+class Sensor : public ObjectSlots::ObjectSlots {
+public:
+    void signal_sample(int value) {
+        emit( &Sensor::signal_sample, value );
+    }
+};
+
+struct Probe {
+    explicit Probe(const Dispatcher& dispatcher) : dispatcher_(dispatcher) { }
+    void onSample(int) { group = dispatcher_.currentGroup(); }
+    const Dispatcher& dispatcher_;
+    std::atomic<std::size_t> group{Dispatcher::AnyGroup};
+};
+
+void testSlotAffinity() {
+    auto dispatcher = std::make_shared<Dispatcher>(twoGroups());
+    const std::size_t narrow = dispatcher->findGroup("narrow");
+    for( auto policy : { Sensor::EmitPolicy::Wait, Sensor::EmitPolicy::Parallel, Sensor::EmitPolicy::Detach } ) {
+        std::vector<std::unique_ptr<Probe>> probes;
+        {
+            Sensor sensor;
+            sensor.setDispatcher(dispatcher);
+            sensor.setEmitPolicy(policy);
+            sensor.setGrainSize(4);
+            for( int i = 0; i < 16; ++i ) {
+                probes.emplace_back(new Probe(*dispatcher));
+                ::ObjectSlots::Connection connection = sensor.bind( &Sensor::signal_sample, probes.back().get(), &Probe::onSample );
+                if( i % 3 == 0 ) {
+                    CHECK( sensor.setAffinity(connection, narrow) );
+                }
+            }
+            sensor.signal_sample(1);
+            // Detached invocations are waited for by the destructor.
+        }
+        for( std::size_t i = 0; i < probes.size(); i += 3 ) {
+            CHECK( probes[i]->group == narrow );
+        }
+    }
+}
+
+void testStagedAffinity() {
+    auto dispatcher = std::make_shared<Dispatcher>(twoGroups());
+    Sensor sensor;
+    sensor.setDispatcher(dispatcher);
+    sensor.setEmitPolicy(Sensor::EmitPolicy::Wait);
+    Probe probe(*dispatcher);
+    ::ObjectSlots::Connection connection;
+    {
+        ::ObjectSlots::Transaction wiring(sensor);
+        connection = sensor.bind( &Sensor::signal_sample, &probe, &Probe::onSample );
+        // The bind is staged, it is stored with the affinity.
+        CHECK( sensor.setAffinity(connection, 1) );
+    }
+    sensor.signal_sample(1);
+    CHECK( probe.group == 1 );
+
+    CHECK( sensor.setAffinity(connection, Dispatcher::AnyGroup) );
+    connection.disconnect();
+    CHECK( !sensor.setAffinity(connection, 1) );
+    Sensor other;
+    ::ObjectSlots::Connection foreign = other.bind( &Sensor::signal_sample, &probe, &Probe::onSample );
+    CHECK( !sensor.setAffinity(foreign, 1) );
+}
+#endif
+
+int main(void) {
+    testGroups();
+    testGroupTasks();
+#ifdef __linux__
+    testPinning();
+#endif
+#ifdef OBJECTSLOTS_THREADED
+    testSlotAffinity();
+    testStagedAffinity();
+#endif
+    return failures == 0 ? 0 : 1;
+}
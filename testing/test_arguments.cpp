@@ -0,0 +1,153 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+/**
+ * @brief Counts how often it is copied.
+ */
+class Payload {
+public:
+    explicit Payload(std::string text) : text(std::move(text)) { }
+    Payload(const Payload& other) : text(other.text) { ++copies; }
+    Payload(Payload&& other) noexcept : text(std::move(other.text)) { ++moves; }
+    Payload& operator=(const Payload&) = delete;
+
+    std::string text;
+    static int copies;
+    static int moves;
+
+    static void resetCounts() {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+int Payload::copies = 0;
+int Payload::moves = 0;
+
+class Publisher : public ObjectSlots::ObjectSlots {
+public:
+    explicit Publisher(bool inlineSlots = true) {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(inlineSlots ? EmitPolicy::Inline : EmitPolicy::Wait);
+#else
+        (void)inlineSlots;
+#endif
+    }
+
+    ::ObjectSlots::Signal<Payload> typed{this};
+
+    void signal_payload(Payload payload) {
+        emit( &Publisher::signal_payload, std::move(payload) );
+    }
+
+    void publish(const Payload& payload) {
+        emit( &Publisher::signal_payload, payload );
+    }
+
+    void signal_reference(const Payload& payload) {
+        emit( &Publisher::signal_reference, payload );
+    }
+
+    void signal_text(std::string text) {
+        emit( &Publisher::signal_text, text );
+    }
+
+    void publishLiteral() {
+        emit( &Publisher::signal_text, "literal" );
+    }
+};
+
+class Subscriber {
+public:
+    void onPayload(const Payload& payload) { length += payload.text.size(); }
+    void onCopy(Payload payload) { length += payload.text.size(); }
+    void onText(const std::string& text) { last = text; }
+    std::size_t length = 0;
+    std::string last;
+};
+
+void testSynchronousSlotsShareArguments() {
+    Publisher publisher;
+    Subscriber subscriber;
+    std::size_t seen = 0;
+    for( int i = 0; i < 8; ++i ) {
+        publisher.bind( &Publisher::signal_payload, &subscriber, &Subscriber::onPayload );
+        publisher.typed.bind( &subscriber, &Subscriber::onPayload );
+    }
+    publisher.bind( &Publisher::signal_payload, [&seen](const Payload& payload) { seen += payload.text.size(); } );
+
+    Payload payload("four");
+    Payload::resetCounts();
+    publisher.publish(payload);
+    publisher.typed(payload);
+    CHECK( Payload::copies == 0 );
+    CHECK( Payload::moves == 0 );
+    CHECK( subscriber.length == 16 * 4 );
+    CHECK( seen == 4 );
+
+    publisher.bind( &Publisher::signal_reference, &subscriber, &Subscriber::onPayload );
+    publisher.signal_reference(payload);
+    CHECK( Payload::copies == 0 );
+
+    // A slot taking its argument by value gets its own copy, and only that.
+    publisher.bind( &Publisher::signal_payload, &subscriber, &Subscriber::onCopy );
+    Payload::resetCounts();
+    publisher.publish(payload);
+    CHECK( Payload::copies == 1 );
+    CHECK( Payload::moves == 0 );
+}
+
+void testConvertedArguments() {
+    Publisher publisher;
+    Subscriber subscriber;
+    publisher.bind( &Publisher::signal_text, &subscriber, &Subscriber::onText );
+    publisher.publishLiteral();
+    CHECK( subscriber.last == "literal" );
+    publisher.signal_text("other");
+    CHECK( subscriber.last == "other" );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+void testThreadedSlotsShareArguments() {
+    Subscriber subscriber;
+    Payload payload("four");
+    {
+        Publisher publisher(false);
+        for( int i = 0; i < 8; ++i ) {
+            publisher.bind( &Publisher::signal_payload, &subscriber, &Subscriber::onPayload );
+        }
+        Payload::resetCounts();
+        publisher.publish(payload);
+        CHECK( Payload::copies == 0 );
+        CHECK( subscriber.length == 8 * 4 );
+
+        // Detached slots share one copy.
+        publisher.setEmitPolicy(Publisher::EmitPolicy::Detach);
+        publisher.publish(payload);
+    }
+    CHECK( Payload::copies == 1 );
+    CHECK( subscriber.length == 16 * 4 );
+}
+#endif
+
+int main(void) {
+    testSynchronousSlotsShareArguments();
+    testConvertedArguments();
+#ifdef OBJECTSLOTS_THREADED
+    testThreadedSlotsShareArguments();
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+#ifdef OBJECTSLOTS_THREADED
+class Source : public ::ObjectSlots::ObjectSlots {
+public:
+    explicit Source(std::shared_ptr<::ObjectSlots::Dispatcher> pool) {
+        setDispatcher(pool);
+    }
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+
+    ::ObjectSlots::Completion signal_value_async(int value) {
+        return emitAsync( &Source::signal_value, value );
+    }
+
+    ::ObjectSlots::Signal<const std::string&> text{this};
+};
+
+static std::atomic<bool> released{false};
+static std::atomic<int> total{0};
+
+void slowValue(int value) {
+    while( !released ) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    total += value;
+}
+
+void fastValue(int value) {
+    total += value;
+}
+
+void testReturnsAtOnce() {
+    auto pool = std::make_shared<::ObjectSlots::Dispatcher>(2);
+    Source source(pool);
+    CHECK( source.signal_value_async(1).ready() );
+
+    source.bind( &Source::signal_value, &slowValue );
+    source.bind( &Source::signal_value, &fastValue );
+    ::ObjectSlots::Completion completion = source.signal_value_async(2);
+    ::ObjectSlots::Completion copy = completion;
+    CHECK( !completion.ready() );
+    CHECK( !copy.waitFor(std::chrono::milliseconds(5)) );
+
+    released = true;
+    completion.wait();
+    CHECK( completion.ready() );
+    CHECK( copy.ready() );
+    CHECK( copy.waitFor(std::chrono::milliseconds(0)) );
+    CHECK( total == 4 );
+}
+
+void testDroppedToken() {
+    auto pool = std::make_shared<::ObjectSlots::Dispatcher>(2);
+    std::string received;
+    {
+        Source source(pool);
+        auto append = [&received](const std::string& value) { received += value; };
+        source.text.bind(append);
+        std::string text("async");
+        source.text.emitAsync(text);
+        text = "changed";
+        // The destructor waits for the invocations nobody waits for.
+    }
+    CHECK( received == "async" );
+}
+
+void testSwitchedDispatcher() {
+    released = false;
+    total = 0;
+    Source source(std::make_shared<::ObjectSlots::Dispatcher>(2));
+    source.bind( &Source::signal_value, &slowValue );
+    ::ObjectSlots::Completion completion = source.signal_value_async(3);
+    std::thread release([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        released = true;
+    });
+    // The token still waits on the pool the emit was queued to.
+    source.setDispatcher(nullptr);
+    completion.wait();
+    CHECK( total == 3 );
+    release.join();
+}
+
+void testLastReference() {
+    released = false;
+    total = 0;
+    {
+        Source source(std::make_shared<::ObjectSlots::Dispatcher>(2));
+        source.bind( &Source::signal_value, &slowValue );
+        ::ObjectSlots::Completion completion = source.signal_value_async(5);
+        source.setDispatcher(nullptr);
+        completion = ::ObjectSlots::Completion();
+        // The pool is destroyed by its own worker, once the slot returns.
+        released = true;
+    }
+    CHECK( total == 5 );
+}
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * @brief A coroutine nobody waits for, enough to co_await a `Completion`.
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+    };
+};
+
+Task awaitEmit(Source& source, std::atomic<int>& state) {
+    state = 1;
+    co_await source.signal_value_async(3);
+    state = total == 3 ? 2 : 3;
+}
+
+void testCoroutine() {
+    auto pool = std::make_shared<::ObjectSlots::Dispatcher>(2);
+    Source source(pool);
+    source.bind( &Source::signal_value, &slowValue );
+    total = 0;
+    released = false;
+
+    std::atomic<int> state{0};
+    awaitEmit(source, state);
+    CHECK( state == 1 );
+    released = true;
+    while( state == 1 ) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK( state == 2 );
+}
+#endif
+#endif
+
+int main(void) {
+#ifdef OBJECTSLOTS_THREADED
+    testReturnsAtOnce();
+    testDroppedToken();
+    testSwitchedDispatcher();
+    testLastReference();
+#if defined(__cpp_impl_coroutine)
+    testCoroutine();
+#endif
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Feed : public ::ObjectSlots::ObjectSlots {
+public:
+    Feed() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_trade(int quantity, double price) {
+        emit( &Feed::signal_trade, quantity, price );
+    }
+
+    void publish(const std::vector<std::tuple<int, double>>& trades) {
+        emitBatch( &Feed::signal_trade, trades );
+    }
+
+    ::ObjectSlots::Signal<const std::string&> symbol{this};
+};
+
+class Book {
+public:
+    void onTrade(int quantity, double price) {
+        ++calls;
+        volume += quantity;
+        notional += quantity * price;
+    }
+    void onTrades(const ::ObjectSlots::Batch<int, double>& trades) {
+        ++batches;
+        for( const auto& [quantity, price] : trades ) {
+            volume += quantity;
+            notional += quantity * price;
+        }
+    }
+    int calls = 0;
+    int batches = 0;
+    int volume = 0;
+    double notional = 0;
+};
+
+static std::string order;
+
+void onSymbols(const ::ObjectSlots::Batch<const std::string&>& symbols) {
+    for( const auto& symbol : symbols ) {
+        order += std::get<0>(symbol);
+    }
+    order += ";";
+}
+
+void testBatchReachesEverySlot() {
+    Feed feed;
+    Book single;
+    Book batched;
+    int lambdaCalls = 0;
+    auto lambda = [&lambdaCalls](int, double) { ++lambdaCalls; };
+
+    feed.bind( &Feed::signal_trade, &single, &Book::onTrade );
+    feed.bindBatch( &Feed::signal_trade, &batched, &Book::onTrades );
+    feed.bind( &Feed::signal_trade, lambda );
+
+    feed.publish({ { 1, 10.0 }, { 2, 20.0 }, { 3, 30.0 } });
+    CHECK( single.calls == 3 );
+    CHECK( single.volume == 6 );
+    CHECK( single.notional == 140.0 );
+    CHECK( batched.batches == 1 );
+    CHECK( batched.volume == 6 );
+    CHECK( batched.notional == 140.0 );
+    CHECK( lambdaCalls == 3 );
+
+    // A single emit is a batch of one, an empty batch invokes nothing.
+    feed.signal_trade(4, 1.0);
+    feed.publish({});
+    CHECK( batched.batches == 2 );
+    CHECK( batched.volume == 10 );
+    CHECK( single.calls == 4 );
+
+    feed.unbind( &batched );
+    feed.publish({ { 1, 1.0 } });
+    CHECK( batched.batches == 2 );
+    CHECK( single.calls == 5 );
+}
+
+void testSignalBatch() {
+    Feed feed;
+    std::string singles;
+    auto append = [&singles](const std::string& symbol) { singles += symbol; };
+    feed.symbol.bind(append);
+    feed.symbol.bindBatch(&onSymbols);
+
+    std::array<std::tuple<std::string>, 3> symbols{ { { "A" }, { "B" }, { "C" } } };
+    feed.symbol.emitBatch(symbols);
+    std::vector<std::tuple<std::string>> more{ { "D" } };
+    feed.symbol.emitBatch(more);
+    CHECK( singles == "ABCD" );
+    CHECK( order == "ABC;D;" );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+void testPolicies() {
+    for( auto policy : { Feed::EmitPolicy::Wait, Feed::EmitPolicy::Detach } ) {
+        Book book;
+        {
+            Feed feed;
+            feed.setEmitPolicy(policy);
+            feed.bindBatch( &Feed::signal_trade, &book, &Book::onTrades );
+            feed.bind( &Feed::signal_trade, &book, &Book::onTrade );
+            feed.publish({ { 1, 1.0 }, { 2, 1.0 } });
+        }
+        CHECK( book.batches == 1 );
+        CHECK( book.calls == 2 );
+        CHECK( book.volume == 6 );
+    }
+}
+#endif
+
+int main(void) {
+    testBatchReachesEverySlot();
+    testSignalBatch();
+#ifdef OBJECTSLOTS_THREADED
+    testPolicies();
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include <iostream>
+
+#include <ObjectSlots/Coalescer.hpp>
+#include <ObjectSlots/EventLoop.hpp>
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Slider : public ::ObjectSlots::ObjectSlots {
+public:
+    Slider() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_moved(int position) {
+        emit( &Slider::signal_moved, position );
+    }
+
+    ::ObjectSlots::Signal<const std::string&> label{this};
+};
+
+class View {
+public:
+    void onMoved(int value) {
+        ++calls;
+        position = value;
+    }
+    int calls = 0;
+    int position = -1;
+};
+
+static int functionCalls = 0;
+
+void onMoved(int) {
+    ++functionCalls;
+}
+
+void testCollapseToLatest() {
+    Slider slider;
+    View direct;
+    View coalesced;
+    ::ObjectSlots::Coalescer coalescer;
+
+    slider.bind( &Slider::signal_moved, &direct, &View::onMoved );
+    slider.bind( &Slider::signal_moved, &coalesced, &View::onMoved, coalescer );
+    slider.bind( &Slider::signal_moved, &onMoved, coalescer );
+
+    for( int i = 0; i < 1000; ++i ) {
+        slider.signal_moved(i);
+    }
+    CHECK( direct.calls == 1000 );
+    CHECK( coalesced.calls == 0 );
+    CHECK( coalescer.pending() == 2 );
+
+    CHECK( coalescer.flush() == 2 );
+    CHECK( coalesced.calls == 1 );
+    CHECK( coalesced.position == 999 );
+    CHECK( functionCalls == 1 );
+    CHECK( coalescer.flush() == 0 );
+
+    // A slot unbound before the flush is not invoked.
+    slider.signal_moved(5);
+    slider.unbind( &coalesced );
+    CHECK( coalescer.flush() == 1 );
+    CHECK( coalesced.calls == 1 );
+    CHECK( functionCalls == 2 );
+}
+
+void testBudget() {
+    Slider slider;
+    std::string latest;
+    int calls = 0;
+    ::ObjectSlots::Coalescer coalescer(std::chrono::milliseconds(20));
+    auto show = [&latest, &calls](const std::string& text) {
+        latest = text;
+        ++calls;
+    };
+    slider.label.bind(show, coalescer);
+
+    slider.label("first");
+    slider.label("second");
+    CHECK( coalescer.poll() == 0 );
+    std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    slider.label("third");
+    CHECK( coalescer.poll() == 1 );
+    CHECK( latest == "third" );
+    CHECK( calls == 1 );
+
+    slider.unbind(show);
+    slider.label("fourth");
+    CHECK( coalescer.pending() == 0 );
+}
+
+void testEventLoopTurn() {
+    Slider slider;
+    View view;
+    ::ObjectSlots::EventLoop loop;
+    ::ObjectSlots::Coalescer coalescer(loop);
+    slider.bind( &Slider::signal_moved, &view, &View::onMoved, coalescer );
+
+    for( int turn = 0; turn < 3; ++turn ) {
+        for( int i = 0; i < 10; ++i ) {
+            slider.signal_moved(turn * 10 + i);
+        }
+        // One flush event per turn, however many emits.
+        CHECK( loop.processEvents() == 1 );
+        CHECK( view.position == turn * 10 + 9 );
+    }
+    CHECK( view.calls == 3 );
+}
+
+void testEmitterDestroyed() {
+    View view;
+    ::ObjectSlots::Coalescer coalescer;
+    auto slider = std::make_unique<Slider>();
+    slider->bind( &Slider::signal_moved, &view, &View::onMoved, coalescer );
+    slider->signal_moved(1);
+    CHECK( coalescer.pending() == 1 );
+
+    // The flush must not reach back into the destroyed emitter.
+    slider.reset();
+    CHECK( coalescer.flush() == 0 );
+    CHECK( view.calls == 0 );
+}
+
+int main(void) {
+    testCollapseToLatest();
+    testBudget();
+    testEventLoopTurn();
+    testEmitterDestroyed();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    int signal_cost(int load) {
+        return collect(&Source::signal_cost, ::ObjectSlots::Sum<int>(), load);
+    }
+
+    std::optional<int> firstCost(int load) {
+        return collect(&Source::signal_cost, ::ObjectSlots::First<int>(), load);
+    }
+
+    std::optional<int> lastCost(int load) {
+        return collect(&Source::signal_cost, ::ObjectSlots::Last<int>(), load);
+    }
+
+    std::optional<int> cheapest(int load) {
+        return collect(&Source::signal_cost, ::ObjectSlots::Min<int>(), load);
+    }
+
+    std::optional<int> dearest(int load) {
+        return collect(&Source::signal_cost, ::ObjectSlots::Max<int>(), load);
+    }
+
+    bool signal_allowed(const std::string& user) {
+        return collect(&Source::signal_allowed, ::ObjectSlots::AllOf(), user);
+    }
+
+    bool anyAllowed(const std::string& user) {
+        return collect(&Source::signal_allowed, ::ObjectSlots::AnyOf(), user);
+    }
+
+    template<class Combiner>
+    auto costs(Combiner combiner, int load) {
+        return collect(&Source::signal_cost, std::move(combiner), load);
+    }
+};
+
+class Estimator {
+public:
+    explicit Estimator(int factor) : factor_(factor) { }
+    int estimate(int load) {
+        ++calls;
+        return load * factor_;
+    }
+    int calls = 0;
+private:
+    int factor_;
+};
+
+void testCombiners() {
+    Source source;
+    CHECK( source.signal_cost(1) == 0 );
+    CHECK( !source.firstCost(1) );
+    CHECK( !source.cheapest(1) );
+    CHECK( source.signal_allowed("anyone") );
+    CHECK( !source.anyAllowed("anyone") );
+
+    Estimator two(2), three(3), one(1);
+    source.bind( &Source::signal_cost, &two, &Estimator::estimate );
+    source.bind( &Source::signal_cost, &three, &Estimator::estimate );
+    source.bind( &Source::signal_cost, &one, &Estimator::estimate );
+
+    CHECK( source.signal_cost(10) == 60 );
+    CHECK( source.lastCost(10) == 10 );
+    CHECK( source.cheapest(10) == 10 );
+    CHECK( source.dearest(10) == 30 );
+    CHECK( two.calls == 4 && three.calls == 4 && one.calls == 4 );
+
+    // First invokes a single slot, in priority order.
+    Estimator urgent(7);
+    source.bind( &Source::signal_cost, &urgent, &Estimator::estimate, Source::Priority::High );
+    CHECK( source.firstCost(1) == 7 );
+    CHECK( two.calls == 4 );
+    source.unbind( &urgent );
+
+    // Stops at the first accepted result, the slots after it are skipped.
+    CHECK( source.costs(::ObjectSlots::firstMatch<int>([](int cost) { return cost > 25; }), 10) == 30 );
+    CHECK( one.calls == 4 );
+    CHECK( !source.costs(::ObjectSlots::firstMatch<int>([](int cost) { return cost > 100; }), 10) );
+    CHECK( one.calls == 5 );
+    CHECK( source.costs(::ObjectSlots::Sum<int>(100), 1) == 106 );
+}
+
+void testShortCircuit() {
+    Source source;
+    std::string log;
+    source.bind( &Source::signal_allowed, [&log](const std::string& user) { log += 'a'; return !user.empty(); } );
+    source.bind( &Source::signal_allowed, [&log](const std::string& user) { log += 'b'; return user == "root"; } );
+    source.bind( &Source::signal_allowed, [&log](const std::string&) { log += 'c'; return true; } );
+
+    CHECK( source.signal_allowed("root") );
+    CHECK( log == "abc" );
+    log.clear();
+    CHECK( !source.signal_allowed("guest") );
+    CHECK( log == "ab" );
+    log.clear();
+    CHECK( !source.signal_allowed("") );
+    CHECK( log == "a" );
+    log.clear();
+    CHECK( source.anyAllowed("root") );
+    CHECK( log == "a" );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+/**
+ * @brief Sums the first `count` results, without short-circuiting.
+ */
+class UpTo {
+public:
+    explicit UpTo(int count) : left_(count) { }
+    bool add(int value) {
+        sum_ += value;
+        return --left_ > 0;
+    }
+    int result() const { return sum_; }
+private:
+    int left_;
+    int sum_ = 0;
+};
+
+void testPooled() {
+    Source source;
+    source.setDispatcher(std::make_shared<::ObjectSlots::Dispatcher>(2));
+    std::atomic<int> calls{0};
+    for( int i = 1; i <= 10; ++i ) {
+        source.bind( &Source::signal_cost, [&calls, i](int load) { ++calls; return load * i; } );
+    }
+
+    source.setEmitPolicy(Source::EmitPolicy::Wait);
+    CHECK( source.signal_cost(1) == 55 );
+    CHECK( source.lastCost(1) == 10 );
+    CHECK( calls == 20 );
+
+    // A wave runs to its end, the next one only starts if the combiner takes more.
+    source.setEmitPolicy(Source::EmitPolicy::Parallel);
+    source.setGrainSize(4);
+    calls = 0;
+    CHECK( source.costs(UpTo(3), 1) == 6 );
+    CHECK( calls == 4 );
+    // Short-circuiting combiners run one slot at a time and stop at once.
+    calls = 0;
+    CHECK( source.costs(::ObjectSlots::firstMatch<int>([](int cost) { return cost >= 3; }), 1) == 3 );
+    CHECK( calls == 3 );
+    source.setEmitPolicy(Source::EmitPolicy::Wait);
+    calls = 0;
+    CHECK( source.firstCost(1) == 1 );
+    CHECK( calls == 1 );
+    calls = 0;
+    CHECK( source.dearest(2) == 20 );
+    CHECK( calls == 10 );
+}
+
+void testThrowingSlot() {
+    Source source;
+    source.setDispatcher(std::make_shared<::ObjectSlots::Dispatcher>(2));
+    source.setEmitPolicy(Source::EmitPolicy::Wait);
+    std::atomic<int> calls{0};
+    // The emitting thread runs the first slot of the wave itself.
+    source.bind( &Source::signal_cost, [](int) -> int { throw std::runtime_error("slot"); } );
+    for( int i = 0; i < 7; ++i ) {
+        source.bind( &Source::signal_cost, [&calls](int load) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            ++calls;
+            return load;
+        } );
+    }
+    bool thrown = false;
+    try {
+        source.signal_cost(1);
+    } catch( const std::runtime_error& ) {
+        thrown = true;
+    }
+    CHECK( thrown );
+    // The rest of the wave finished before the exception left collect().
+    CHECK( calls == 7 );
+}
+#endif
+
+int main(void) {
+    testCombiners();
+    testShortCircuit();
+#ifdef OBJECTSLOTS_THREADED
+    testPooled();
+    testThrowingSlot();
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Bus : public ObjectSlots::ObjectSlots {
+public:
+    void signal_tick(int amount) {
+        emit( &Bus::signal_tick, amount );
+    }
+};
+
+static std::atomic<long> ticks{0};
+
+void onTick(int amount) {
+    ticks += amount;
+}
+
+class Listener {
+public:
+    void onTick(int amount) {
+        received += amount;
+    }
+    std::atomic<long> received{0};
+};
+
+#ifdef OBJECTSLOTS_THREAD_SAFE
+void testEmitWhileBinding() {
+    Bus bus;
+#ifdef OBJECTSLOTS_THREADED
+    bus.setEmitPolicy(Bus::EmitPolicy::Inline);
+#endif
+    bus.bind( &Bus::signal_tick, &onTick );
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> emitters;
+    for( int i = 0; i < 4; ++i ) {
+        emitters.emplace_back([&bus, &running]() {
+            while( running ) {
+                bus.signal_tick(1);
+                // The shared mutex prefers readers, give the writer a chance.
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<Listener> listeners(16);
+    for( int round = 0; round < 50; ++round ) {
+        for( auto& listener : listeners ) {
+            bus.bind( &Bus::signal_tick, &listener, &Listener::onTick );
+        }
+        for( auto& listener : listeners ) {
+            bus.unbind( &listener );
+        }
+    }
+    running = false;
+    for( auto& emitter : emitters ) {
+        emitter.join();
+    }
+
+    // The free function stayed bound the whole time.
+    const long before = ticks;
+    bus.signal_tick(1);
+    CHECK( ticks == before + 1 );
+    for( auto& listener : listeners ) {
+        const long received = listener.received;
+        bus.signal_tick(1);
+        CHECK( listener.received == received );
+    }
+}
+#endif
+
+int main(void) {
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    testEmitWhileBinding();
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Button : public ObjectSlots::ObjectSlots {
+public:
+    Button() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_clicked(int id) {
+        emit( &Button::signal_clicked, id );
+    }
+};
+
+class Recorder {
+public:
+    void onClicked(int id) { ids.push_back(id); }
+    std::vector<int> ids;
+};
+
+static int functionClicks = 0;
+
+void onClicked(int) {
+    ++functionClicks;
+}
+
+void testDisconnect() {
+    Button button;
+    Recorder recorder;
+    std::string suffix("!");
+    std::string log;
+
+    ::ObjectSlots::Connection method = button.bind( &Button::signal_clicked, &recorder, &Recorder::onClicked );
+    ::ObjectSlots::Connection function = button.bind( &Button::signal_clicked, &onClicked );
+    ::ObjectSlots::Connection lambda = button.bind( &Button::signal_clicked, [suffix, &log](int id) { log += std::to_string(id) + suffix; } );
+
+    CHECK( method.connected() );
+    CHECK( method.owner() == &button );
+    button.signal_clicked(1);
+
+    function.disconnect();
+    CHECK( !function.connected() );
+    CHECK( function.owner() == nullptr );
+    button.signal_clicked(2);
+
+    // A copy of a disconnected handle is stale and ignored.
+    ::ObjectSlots::Connection copy = lambda;
+    button.unbind( lambda );
+    CHECK( !button.connected(copy) );
+    button.unbind( copy );
+    button.signal_clicked(3);
+
+    CHECK( (recorder.ids == std::vector<int>{ 1, 2, 3 }) );
+    CHECK( functionClicks == 1 );
+    CHECK( log == "1!2!" );
+
+    // A slot bound after a disconnect does not revive old handles.
+    ::ObjectSlots::Connection again = button.bind( &Button::signal_clicked, &onClicked );
+    CHECK( again.connected() );
+    CHECK( !copy.connected() );
+
+    ::ObjectSlots::Connection empty;
+    CHECK( !empty.connected() );
+    empty.disconnect();
+    method.disconnect();
+    again.disconnect();
+    button.signal_clicked(4);
+    CHECK( recorder.ids.size() == 3 );
+    CHECK( functionClicks == 1 );
+}
+
+void testScopedConnection() {
+    Button button;
+    Recorder recorder;
+    {
+        ::ObjectSlots::ScopedConnection scoped = button.bind( &Button::signal_clicked, &recorder, &Recorder::onClicked );
+        button.signal_clicked(1);
+        ::ObjectSlots::ScopedConnection moved(std::move(scoped));
+        CHECK( !scoped.get().connected() );
+        CHECK( moved.get().connected() );
+        button.signal_clicked(2);
+    }
+    button.signal_clicked(3);
+    CHECK( (recorder.ids == std::vector<int>{ 1, 2 }) );
+
+    ::ObjectSlots::Connection kept;
+    {
+        ::ObjectSlots::ScopedConnection scoped = button.bind( &Button::signal_clicked, &recorder, &Recorder::onClicked );
+        kept = scoped.release();
+    }
+    CHECK( kept.connected() );
+}
+
+void testOrderAndCompaction() {
+    Button button;
+    Recorder recorder;
+    std::vector<::ObjectSlots::Connection> connections;
+    for( int i = 0; i < 100; ++i ) {
+        connections.push_back( button.bind( &Button::signal_clicked, [&recorder, i](int) { recorder.ids.push_back(i); } ) );
+    }
+    // Unbinding every other connection compacts the slot array on the way,
+    // the remaining handles must still find their slots.
+    for( int i = 0; i < 100; i += 2 ) {
+        connections[i].disconnect();
+    }
+    button.signal_clicked(0);
+    CHECK( recorder.ids.size() == 50 );
+    bool ordered = true;
+    for( std::size_t i = 0; i < recorder.ids.size(); ++i ) {
+        ordered &= recorder.ids[i] == static_cast<int>(2 * i + 1);
+    }
+    CHECK( ordered );
+
+    // Mixing handle and pointer based unbinds.
+    Recorder other;
+    ::ObjectSlots::Connection method = button.bind( &Button::signal_clicked, &other, &Recorder::onClicked );
+    for( int i = 1; i < 50; i += 2 ) {
+        connections[i].disconnect();
+    }
+    button.unbind( &other );
+    CHECK( !method.connected() );
+    for( int i = 51; i < 100; i += 2 ) {
+        CHECK( connections[i].connected() );
+        connections[i].disconnect();
+    }
+    recorder.ids.clear();
+    button.signal_clicked(0);
+    CHECK( recorder.ids.empty() );
+    CHECK( other.ids.empty() );
+}
+
+void testPlanFollowsChanges() {
+    Button button;
+    Recorder recorder;
+    std::vector<::ObjectSlots::Connection> connections;
+    for( int i = 0; i < 8; ++i ) {
+        connections.push_back( button.bind( &Button::signal_clicked, [&recorder, i](int) { recorder.ids.push_back(i); } ) );
+    }
+    button.signal_clicked(0);
+    CHECK( recorder.ids.size() == 8 );
+
+    // Each emit after a change runs the slots bound at that moment.
+    connections[2].disconnect();
+    connections[5].disconnect();
+    recorder.ids.clear();
+    button.signal_clicked(0);
+    button.signal_clicked(0);
+    CHECK( (recorder.ids == std::vector<int>{ 0, 1, 3, 4, 6, 7, 0, 1, 3, 4, 6, 7 }) );
+
+    connections[2] = button.bind( &Button::signal_clicked, [&recorder](int) { recorder.ids.push_back(8); } );
+    recorder.ids.clear();
+    button.signal_clicked(0);
+    CHECK( (recorder.ids == std::vector<int>{ 0, 1, 3, 4, 6, 7, 8 }) );
+
+    for( auto& connection : connections ) {
+        connection.disconnect();
+    }
+    recorder.ids.clear();
+    button.signal_clicked(0);
+    CHECK( recorder.ids.empty() );
+}
+
+class Panel : public ObjectSlots::Receiver {
+public:
+    void onClicked(int id) { ids.push_back(id); }
+    void onOther(int id) { others.push_back(id); }
+    std::vector<int> ids;
+    std::vector<int> others;
+};
+
+void testUnbindObject() {
+    Button button;
+    Recorder first;
+    Recorder second;
+    for( int i = 0; i < 10; ++i ) {
+        button.bind( &Button::signal_clicked, &first, &Recorder::onClicked );
+        button.bind( &Button::signal_clicked, &second, &Recorder::onClicked );
+    }
+    button.signal_clicked(1);
+    button.unbind( &first );
+    button.signal_clicked(2);
+    CHECK( first.ids.size() == 10 );
+    CHECK( second.ids.size() == 20 );
+
+    Panel panel;
+    button.bind( &Button::signal_clicked, &panel, &Panel::onClicked );
+    button.bind( &Button::signal_clicked, &panel, &Panel::onOther );
+    button.unbind( &panel, &Panel::onOther );
+    button.signal_clicked(3);
+    CHECK( (panel.ids == std::vector<int>{ 3 }) );
+    CHECK( panel.others.empty() );
+
+    // Removing objects from the index in an arbitrary order.
+    std::vector<Recorder> many(64);
+    for( auto& recorder : many ) {
+        button.bind( &Button::signal_clicked, &recorder, &Recorder::onClicked );
+    }
+    for( std::size_t i = 0; i < many.size(); ++i ) {
+        button.unbind( &many[(i * 37) % many.size()] );
+    }
+    button.signal_clicked(4);
+    bool untouched = true;
+    for( auto& recorder : many ) {
+        untouched &= recorder.ids.empty();
+    }
+    CHECK( untouched );
+
+    // One object's connections disconnected out of order, then the rest at once.
+    Recorder third;
+    std::vector<::ObjectSlots::Connection> connections;
+    for( int i = 0; i < 16; ++i ) {
+        connections.push_back( button.bind( &Button::signal_clicked, &third, &Recorder::onClicked ) );
+    }
+    for( std::size_t i = 0; i < connections.size(); i += 3 ) {
+        connections[(i * 5) % connections.size()].disconnect();
+    }
+    button.signal_clicked(5);
+    const std::size_t left = third.ids.size();
+    button.unbind( &third );
+    button.signal_clicked(6);
+    CHECK( left == 10 );
+    CHECK( third.ids.size() == left );
+    for( const ::ObjectSlots::Connection& connection : connections ) {
+        CHECK( !connection.connected() );
+    }
+}
+
+void testReceiver() {
+    Button first;
+    Button second;
+    Recorder recorder;
+    first.bind( &Button::signal_clicked, &recorder, &Recorder::onClicked );
+    {
+        Panel panel;
+        first.bind( &Button::signal_clicked, &panel, &Panel::onClicked );
+        second.bind( &Button::signal_clicked, &panel, &Panel::onClicked );
+        second.bind( &Button::signal_clicked, &panel, &Panel::onOther );
+        first.signal_clicked(1);
+        second.signal_clicked(2);
+        CHECK( (panel.ids == std::vector<int>{ 1, 2 }) );
+        CHECK( (panel.others == std::vector<int>{ 2 }) );
+
+        panel.unbindAll();
+        first.signal_clicked(3);
+        second.signal_clicked(4);
+        CHECK( panel.ids.size() == 2 );
+        CHECK( panel.others.size() == 1 );
+
+        // Bound again, unbound by its destructor.
+        first.bind( &Button::signal_clicked, &panel, &Panel::onClicked );
+    }
+    first.signal_clicked(5);
+    CHECK( (recorder.ids == std::vector<int>{ 1, 3, 5 }) );
+
+    // An emitter destroyed first is forgotten by its receivers.
+    Panel panel;
+    {
+        Button transient;
+        transient.bind( &Button::signal_clicked, &panel, &Panel::onClicked );
+        first.bind( &Button::signal_clicked, &panel, &Panel::onClicked );
+    }
+    panel.unbindAll();
+    first.signal_clicked(6);
+    CHECK( panel.ids.empty() );
+}
+
+int main(void) {
+    testDisconnect();
+    testScopedConnection();
+    testOrderAndCompaction();
+    testPlanFollowsChanges();
+    testUnbindObject();
+    testReceiver();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+
+#include <ObjectSlots/Dispatcher.hpp>
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Counter : public ObjectSlots::ObjectSlots {
+public:
+    void signal_count(int amount) {
+        emit( &Counter::signal_count, amount );
+    }
+};
+
+static std::atomic<int> total{0};
+
+void onCount(int amount) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    total += amount;
+}
+
+void testSubmitAndWait() {
+    ObjectSlots::Dispatcher dispatcher(4);
+    CHECK( dispatcher.size() == 4 );
+
+    std::atomic<int> ran{0};
+    ObjectSlots::TaskGroup group;
+    for( int i = 0; i < 1000; ++i ) {
+        dispatcher.submit([&ran]() { ++ran; }, &group);
+    }
+    dispatcher.wait(group);
+    CHECK( group.done() );
+    CHECK( ran == 1000 );
+}
+
+void testNestedWait() {
+    // Every worker blocks in a nested wait; the waiters must run the
+    // inner tasks themselves instead of deadlocking.
+    ObjectSlots::Dispatcher dispatcher(2);
+    std::atomic<int> ran{0};
+    ObjectSlots::TaskGroup outer;
+    for( int i = 0; i < 8; ++i ) {
+        dispatcher.submit([&dispatcher, &ran]() {
+            ObjectSlots::TaskGroup inner;
+            for( int j = 0; j < 8; ++j ) {
+                dispatcher.submit([&ran]() { ++ran; }, &inner);
+            }
+            dispatcher.wait(inner);
+        }, &outer);
+    }
+    dispatcher.wait(outer);
+    CHECK( ran == 64 );
+}
+
+void testDestructorDrains() {
+    std::atomic<int> ran{0};
+    {
+        ObjectSlots::Dispatcher dispatcher(1);
+        for( int i = 0; i < 100; ++i ) {
+            dispatcher.submit([&ran]() { ++ran; });
+        }
+    }
+    CHECK( ran == 100 );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+void testEmitPolicies() {
+    auto dispatcher = std::make_shared<ObjectSlots::Dispatcher>(4);
+    Counter* counter = new Counter();
+    counter->setDispatcher(dispatcher);
+    CHECK( counter->dispatcher() == dispatcher );
+    CHECK( counter->emitPolicy() == Counter::EmitPolicy::Wait );
+
+    for( int i = 0; i < 8; ++i ) {
+        counter->bind( &Counter::signal_count, &onCount );
+    }
+
+    total = 0;
+    counter->signal_count(1);
+    CHECK( total == 8 );
+
+    counter->setEmitPolicy(Counter::EmitPolicy::Inline);
+    counter->signal_count(1);
+    CHECK( total == 16 );
+
+    // Detached invocations may still be running when emit() returns,
+    // the destructor waits for them.
+    counter->setEmitPolicy(Counter::EmitPolicy::Detach);
+    counter->signal_count(1);
+    counter->unbind( &onCount );
+    counter->signal_count(1);
+    delete counter;
+    CHECK( total == 24 );
+}
+#endif
+
+int main(void) {
+    testSubmitAndWait();
+    testNestedWait();
+    testDestructorDrains();
+#ifdef OBJECTSLOTS_THREADED
+    testEmitPolicies();
+#endif
+    return failures == 0 ? 0 : 1;
+}
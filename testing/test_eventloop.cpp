@@ -0,0 +1,165 @@
+#include <iostream>
+
+#include <ObjectSlots/EventLoop.hpp>
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ::ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+
+    void signal_text(const std::string& text) {
+        emit( &Source::signal_text, text );
+    }
+
+    ::ObjectSlots::Signal<int> changed{this};
+};
+
+class Sink {
+public:
+    void onValue(int value) {
+        sum += value;
+        thread = std::this_thread::get_id();
+    }
+    void onText(const std::string& value) { text += value; }
+    int sum = 0;
+    std::string text;
+    std::thread::id thread;
+};
+
+static int functionSum = 0;
+
+void onValue(int value) {
+    functionSum += value;
+}
+
+void testQueuedDelivery() {
+    Source source;
+    Sink direct;
+    Sink queued;
+    ::ObjectSlots::EventLoop loop;
+    int lambdaSum = 0;
+
+    source.bind( &Source::signal_value, &direct, &Sink::onValue );
+    source.bind( &Source::signal_value, &queued, &Sink::onValue, loop );
+    source.bind( &Source::signal_value, &onValue, loop );
+    auto lambda = [&lambdaSum](int value) { lambdaSum += value; };
+    source.bind( &Source::signal_value, lambda, loop );
+    source.bind( &Source::signal_text, &queued, &Sink::onText, loop );
+
+    source.signal_value(2);
+    {
+        // The event owns a copy of the argument.
+        std::string text("queued");
+        source.signal_text(text);
+    }
+    CHECK( direct.sum == 2 );
+    CHECK( queued.sum == 0 );
+    CHECK( functionSum == 0 );
+    CHECK( lambdaSum == 0 );
+
+    CHECK( loop.processEvents() == 4 );
+    CHECK( queued.sum == 2 );
+    CHECK( queued.text == "queued" );
+    CHECK( functionSum == 2 );
+    CHECK( lambdaSum == 2 );
+    CHECK( loop.processEvents() == 0 );
+
+    // Unbinding by object and callback finds queued slots as well.
+    source.unbind( &queued );
+    source.unbind( &onValue );
+    source.unbind( lambda );
+    source.signal_value(1);
+    CHECK( loop.processEvents() == 0 );
+    CHECK( direct.sum == 3 );
+}
+
+void testSignalAndBatches() {
+    Source source;
+    Sink sink;
+    ::ObjectSlots::EventLoop loop(4);
+    CHECK( loop.capacity() == 4 );
+
+    ::ObjectSlots::Connection connection = source.changed.bind( &sink, &Sink::onValue, loop );
+    for( int i = 0; i < 3; ++i ) {
+        source.changed(1);
+    }
+    CHECK( loop.processEvents(2) == 2 );
+    CHECK( sink.sum == 2 );
+    CHECK( loop.processEvents() == 1 );
+
+    ::ObjectSlots::EventLoop::Event event = []() { };
+    for( int i = 0; i < 4; ++i ) {
+        source.changed(1);
+    }
+    CHECK( !loop.tryPost(event) );
+    CHECK( loop.processEvents() == 4 );
+    CHECK( loop.tryPost(event) );
+    CHECK( loop.processEvents() == 1 );
+
+    connection.disconnect();
+    source.changed(1);
+    CHECK( loop.processEvents() == 0 );
+    CHECK( sink.sum == 7 );
+}
+
+void testRunOnReceiverThread() {
+    Source source;
+    Sink sink;
+    ::ObjectSlots::EventLoop loop(16);
+    std::thread::id receiverThread;
+    std::thread receiver([&loop, &receiverThread]() {
+        receiverThread = std::this_thread::get_id();
+        loop.run();
+    });
+
+    source.bind( &Source::signal_value, &sink, &Sink::onValue, loop );
+    std::vector<std::thread> emitters;
+    for( int i = 0; i < 4; ++i ) {
+        emitters.emplace_back([&source]() {
+            for( int n = 0; n < 1000; ++n ) {
+                source.signal_value(1);
+            }
+        });
+    }
+    for( auto& emitter : emitters ) {
+        emitter.join();
+    }
+    loop.quit();
+    receiver.join();
+
+    // Every event posted before quit() ran, on the receiver's thread.
+    CHECK( sink.sum == 4000 );
+    CHECK( sink.thread == receiverThread );
+}
+
+int main(void) {
+    testQueuedDelivery();
+    testSignalAndBatches();
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    testRunOnReceiverThread();
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+#ifdef OBJECTSLOTS_THREADED
+class Broadcast : public ObjectSlots::ObjectSlots {
+public:
+    void signal_value(int value) {
+        emit( &Broadcast::signal_value, value );
+    }
+
+    void signal_values(const std::vector<std::tuple<int>>& values) {
+        emitBatch( &Broadcast::signal_value, values );
+    }
+};
+
+class Subscriber {
+public:
+    void onValue(int value) {
+        sum += value;
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    }
+    std::atomic<int> sum{0};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+};
+
+void testGrainSize() {
+    Broadcast broadcast;
+    CHECK( broadcast.grainSize() == 64 );
+    broadcast.setGrainSize(16);
+    CHECK( broadcast.grainSize() == 16 );
+    broadcast.setGrainSize(0);
+    CHECK( broadcast.grainSize() == 1 );
+}
+
+void testEverySlotRunsOnce() {
+    Broadcast broadcast;
+    broadcast.setDispatcher(std::make_shared<ObjectSlots::Dispatcher>(4));
+    broadcast.setEmitPolicy(Broadcast::EmitPolicy::Parallel);
+    broadcast.setGrainSize(100);
+
+    std::vector<Subscriber> subscribers(1000);
+    for( auto& subscriber : subscribers ) {
+        broadcast.bind( &Broadcast::signal_value, &subscriber, &Subscriber::onValue );
+    }
+    // Disconnected slots left in the array are skipped.
+    for( std::size_t i = 0; i < subscribers.size(); i += 7 ) {
+        broadcast.unbind( &subscribers[i] );
+    }
+
+    broadcast.signal_value(3);
+    // emit() returned, so every chunk has finished.
+    for( std::size_t i = 0; i < subscribers.size(); ++i ) {
+        CHECK( subscribers[i].sum == (i % 7 == 0 ? 0 : 3) );
+    }
+
+    broadcast.signal_values({ std::make_tuple(1), std::make_tuple(2) });
+    for( std::size_t i = 0; i < subscribers.size(); ++i ) {
+        CHECK( subscribers[i].sum == (i % 7 == 0 ? 0 : 6) );
+    }
+}
+
+void testSmallSignalStaysOnEmitter() {
+    Broadcast broadcast;
+    broadcast.setEmitPolicy(Broadcast::EmitPolicy::Parallel);
+    broadcast.setGrainSize(8);
+
+    std::vector<Subscriber> subscribers(8);
+    for( auto& subscriber : subscribers ) {
+        broadcast.bind( &Broadcast::signal_value, &subscriber, &Subscriber::onValue );
+    }
+    broadcast.signal_value(1);
+    for( auto& subscriber : subscribers ) {
+        CHECK( subscriber.sum == 1 );
+        CHECK( subscriber.threads.size() == 1 );
+        CHECK( subscriber.threads.count(std::this_thread::get_id()) == 1 );
+    }
+}
+
+void testNestedParallelEmit() {
+    // A slot running on a worker emits in parallel again, waiting there
+    // runs queued chunks instead of blocking the pool.
+    Broadcast outer;
+    Broadcast inner;
+    auto dispatcher = std::make_shared<ObjectSlots::Dispatcher>(2);
+    for( Broadcast* broadcast : { &outer, &inner } ) {
+        broadcast->setDispatcher(dispatcher);
+        broadcast->setEmitPolicy(Broadcast::EmitPolicy::Parallel);
+        broadcast->setGrainSize(1);
+    }
+
+    std::atomic<int> reached{0};
+    for( int i = 0; i < 4; ++i ) {
+        inner.bind( &Broadcast::signal_value, [&reached](int value) { reached += value; } );
+        outer.bind( &Broadcast::signal_value, [&inner](int value) { inner.signal_value(value); } );
+    }
+    outer.signal_value(1);
+    CHECK( reached == 16 );
+}
+
+void testThrowingSlot() {
+    Broadcast broadcast;
+    broadcast.setDispatcher(std::make_shared<ObjectSlots::Dispatcher>(4));
+    broadcast.setEmitPolicy(Broadcast::EmitPolicy::Parallel);
+    broadcast.setGrainSize(4);
+    std::atomic<int> calls{0};
+    // The first chunk runs on the emitting thread, its first slot throws.
+    broadcast.bind( &Broadcast::signal_value, [](int) { throw std::runtime_error("slot"); } );
+    for( int i = 1; i < 64; ++i ) {
+        broadcast.bind( &Broadcast::signal_value, [&calls](int) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            ++calls;
+        } );
+    }
+    bool thrown = false;
+    try {
+        broadcast.signal_value(1);
+    } catch( const std::runtime_error& ) {
+        thrown = true;
+    }
+    CHECK( thrown );
+    // The other chunks finished before the exception left emit().
+    CHECK( calls == 60 );
+}
+#endif
+
+int main(void) {
+#ifdef OBJECTSLOTS_THREADED
+    testGrainSize();
+    testEverySlotRunsOnce();
+    testSmallSignalStaysOnEmitter();
+    testNestedParallelEmit();
+    testThrowingSlot();
+#endif
+    return failures == 0 ? 0 : 1;
+}
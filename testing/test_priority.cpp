@@ -0,0 +1,157 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+};
+
+using Priority = ::ObjectSlots::ObjectSlots::Priority;
+
+class Recorder {
+public:
+    explicit Recorder(std::string& log, char name) : log_(log), name_(name) { }
+    void onValue(int) { log_ += name_; }
+private:
+    std::string& log_;
+    char name_;
+};
+
+static std::string functionLog;
+
+void onValue(int) {
+    functionLog += 'f';
+}
+
+void testOrder() {
+    Source source;
+    std::string log;
+    Recorder a(log, 'a'), b(log, 'b'), c(log, 'c'), d(log, 'd'), e(log, 'e');
+
+    source.bind( &Source::signal_value, &a, &Recorder::onValue );
+    source.bind( &Source::signal_value, &b, &Recorder::onValue, Priority::Low );
+    source.bind( &Source::signal_value, &c, &Recorder::onValue, Priority::High );
+    source.bind( &Source::signal_value, &d, &Recorder::onValue );
+    source.bind( &Source::signal_value, &e, &Recorder::onValue, Priority::Urgent );
+    source.bind( &Source::signal_value, [&log](int) { log += 'x'; }, static_cast<Priority>(50) );
+    source.signal_value(1);
+    CHECK( log == "ecxadb" );
+
+    // Slots bound after an unbind still find their place.
+    source.unbind( &c );
+    source.bind( &Source::signal_value, &onValue, Priority::High );
+    log.clear();
+    functionLog.clear();
+    source.signal_value(1);
+    CHECK( log == "exadb" );
+    CHECK( functionLog == "f" );
+
+    source.unbind( &a );
+    source.bind( &Source::signal_value, &a, &Recorder::onValue, Priority::Low );
+    log.clear();
+    source.signal_value(1);
+    CHECK( log == "exdba" );
+}
+
+void testTypedSignal() {
+    Source source;
+    std::string log;
+    Recorder a(log, 'a'), b(log, 'b');
+    source.typed.bind( &a, &Recorder::onValue );
+    source.typed.bind( [&log](int) { log += 'x'; }, ::ObjectSlots::Signal<int>::Priority::High );
+    source.typed.bind( &b, &Recorder::onValue, Priority::High );
+    source.typed(1);
+    CHECK( log == "xba" );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+void testUrgentLane() {
+    Source source;
+    auto regular = std::make_shared<::ObjectSlots::Dispatcher>(1);
+    auto urgent = std::make_shared<::ObjectSlots::Dispatcher>(1);
+    source.setDispatcher(regular);
+    CHECK( source.urgentDispatcher() == nullptr );
+    source.setUrgentDispatcher(urgent);
+    CHECK( source.urgentDispatcher() == urgent );
+
+    // The only regular worker is stuck until the urgent slot has run,
+    // which it could not if the urgent slot were queued behind it.
+    std::atomic<bool> released{false};
+    std::atomic<bool> slowDone{false};
+    source.bind( &Source::signal_value, [&released, &slowDone](int) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while( !released && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::yield();
+        }
+        slowDone = true;
+    } );
+    std::atomic<int> urgentCalls{0};
+    source.bind( &Source::signal_value, [&released, &urgentCalls](int value) {
+        urgentCalls += value;
+        released = true;
+    }, Priority::Urgent );
+
+    source.setEmitPolicy(Source::EmitPolicy::Detach);
+    source.signal_value(1);
+    CHECK( source.urgentDispatcher() == urgent );
+    ::ObjectSlots::TaskGroup group;
+    regular->submit([]() { }, &group);
+    regular->wait(group);
+    CHECK( released );
+    CHECK( slowDone );
+    CHECK( urgentCalls == 1 );
+
+    for( auto policy : { Source::EmitPolicy::Wait, Source::EmitPolicy::Parallel } ) {
+        released = false;
+        slowDone = false;
+        source.setEmitPolicy(policy);
+        source.signal_value(1);
+        CHECK( released );
+        CHECK( slowDone );
+    }
+    CHECK( urgentCalls == 3 );
+
+    source.setUrgentDispatcher(nullptr);
+    CHECK( source.urgentDispatcher() == nullptr );
+    source.setEmitPolicy(Source::EmitPolicy::Inline);
+    released = false;
+    source.signal_value(1);
+    CHECK( urgentCalls == 4 );
+}
+#endif
+
+int main(void) {
+    testOrder();
+    testTypedSignal();
+#ifdef OBJECTSLOTS_THREADED
+    testUrgentLane();
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    explicit Source(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : ObjectSlots(resource) {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+
+    void signal_other(int value) {
+        emit( &Source::signal_other, value );
+    }
+};
+
+class Sink {
+public:
+    void onValue(int value) { sum += value; }
+    int sum = 0;
+};
+
+void testBindFromSlot() {
+    Source source;
+    Sink sink;
+    ::ObjectSlots::Connection added;
+    int calls = 0;
+    source.bind( &Source::signal_value, [&](int) {
+        if( calls++ == 0 ) {
+            added = source.bind( &Source::signal_value, &sink, &Sink::onValue );
+            // The handle works before the slot is stored.
+            CHECK( added.connected() );
+        }
+    } );
+
+    // The emit in progress keeps the list it started with.
+    source.signal_value(1);
+    CHECK( sink.sum == 0 );
+    CHECK( added.connected() );
+    source.signal_value(2);
+    CHECK( sink.sum == 2 );
+
+    // Typed signals defer just the same.
+    source.typed.bind( [&](int value) { source.typed.bind( &sink, &Sink::onValue ); sink.sum += value * 10; } );
+    source.typed(1);
+    CHECK( sink.sum == 12 );
+    source.typed(1);
+    CHECK( sink.sum == 23 );
+}
+
+void testUnbindFromSlot() {
+    Source source;
+    std::string text("a heap allocated slot");
+    std::string log;
+    ::ObjectSlots::Connection self;
+    self = source.bind( &Source::signal_value, [&self, &log, text](int) {
+        self.disconnect();
+        // Still alive, it is only deleted after the emit.
+        log += text;
+    } );
+    Sink sink;
+    source.bind( &Source::signal_value, &sink, &Sink::onValue );
+
+    source.signal_value(1);
+    source.signal_value(1);
+    CHECK( log == text );
+    CHECK( sink.sum == 2 );
+
+    // Unbinding an object applies after the emit as well.
+    source.bind( &Source::signal_other, [&](int) { source.unbind( &sink ); } );
+    source.bind( &Source::signal_other, &sink, &Sink::onValue );
+    source.signal_other(1);
+    CHECK( sink.sum == 3 );
+    source.signal_value(1);
+    source.signal_other(1);
+    CHECK( sink.sum == 3 );
+}
+
+void testOrderOfChanges() {
+    Source source;
+    Sink sink;
+    bool once = true;
+    source.bind( &Source::signal_value, [&](int) {
+        if( !once ) {
+            return;
+        }
+        once = false;
+        // Bound and unbound within one emit, it is never called.
+        ::ObjectSlots::Connection temporary = source.bind( &Source::signal_other, &sink, &Sink::onValue );
+        temporary.disconnect();
+        CHECK( !temporary.connected() );
+        source.bind( &Source::signal_other, &sink, &Sink::onValue );
+    } );
+    source.signal_value(1);
+    source.signal_other(5);
+    CHECK( sink.sum == 5 );
+}
+
+void testNestedEmits() {
+    Source source;
+    Sink sink;
+    int inner = 0;
+    source.bind( &Source::signal_other, [&](int) {
+        ++inner;
+        if( inner == 1 ) {
+            source.bind( &Source::signal_other, &sink, &Sink::onValue );
+        }
+    } );
+    source.bind( &Source::signal_value, [&](int value) {
+        source.signal_other(value);
+        // Applied once the outermost emit returns, not the inner one.
+        source.signal_other(value);
+    } );
+    source.signal_value(1);
+    CHECK( inner == 2 );
+#ifdef OBJECTSLOTS_LOCK_FREE
+    // Lock-free builds publish it at once, only the emit in progress misses it.
+    CHECK( sink.sum == 1 );
+#else
+    CHECK( sink.sum == 0 );
+#endif
+    const int before = sink.sum;
+    source.signal_other(1);
+    CHECK( sink.sum == before + 1 );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+void testSlotsOnWorkers() {
+    Source source;
+    Sink sink;
+    source.setDispatcher(std::make_shared<::ObjectSlots::Dispatcher>(2));
+    bool once = true;
+    source.bind( &Source::signal_value, [&](int) {
+        // Runs on a worker while the emitting thread waits.
+        if( once ) {
+            once = false;
+            source.bind( &Source::signal_value, &sink, &Sink::onValue );
+        }
+    } );
+    source.setEmitPolicy(Source::EmitPolicy::Wait);
+    source.signal_value(1);
+    source.signal_value(2);
+    CHECK( sink.sum == 2 );
+
+    source.setEmitPolicy(Source::EmitPolicy::Parallel);
+    source.setGrainSize(1);
+    source.bind( &Source::signal_value, [&](int) { source.unbind( &sink ); } );
+    source.signal_value(1);
+    source.signal_value(1);
+    CHECK( sink.sum == 3 );
+}
+#endif
+
+/**
+ * @brief Counts the allocations made through it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void testEmitsStayCopyFree() {
+    CountingResource counting;
+    Source source(&counting);
+    Sink sink;
+    for( int i = 0; i < 8; ++i ) {
+        source.bind( &Source::signal_value, &sink, &Sink::onValue );
+    }
+    source.signal_value(1);
+    const std::size_t allocations = counting.allocations;
+    for( int i = 0; i < 100; ++i ) {
+        source.signal_value(1);
+    }
+    CHECK( counting.allocations == allocations );
+    CHECK( sink.sum == 808 );
+}
+
+int main(void) {
+    testBindFromSlot();
+    testUnbindFromSlot();
+    testOrderOfChanges();
+    testNestedEmits();
+#ifdef OBJECTSLOTS_THREADED
+    testSlotsOnWorkers();
+#endif
+    testEmitsStayCopyFree();
+    return failures == 0 ? 0 : 1;
+}
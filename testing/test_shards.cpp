@@ -0,0 +1,224 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+/**
+ * @brief An emitter with many independent signals.
+ */
+class Hub : public ObjectSlots::ObjectSlots {
+public:
+    explicit Hub(std::size_t shards, std::size_t count = 16) : ObjectSlots(Shards{shards}) {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+        for( std::size_t i = 0; i < count; ++i ) {
+            signals.emplace_back(new ::ObjectSlots::Signal<int>(this));
+        }
+    }
+
+    ::ObjectSlots::Signal<int>& operator[](std::size_t i) { return *signals[i]; }
+
+    void signal_value(int value) {
+        emit( &Hub::signal_value, value );
+    }
+
+    std::vector<std::unique_ptr<::ObjectSlots::Signal<int>>> signals;
+};
+
+class Counter : public ObjectSlots::Receiver {
+public:
+    void onValue(int value) { sum += value; }
+    std::atomic<long> sum{0};
+};
+
+static std::atomic<long> functionSum{0};
+
+void onValue(int value) {
+    functionSum += value;
+}
+
+void testShardCount() {
+    Hub plain(1);
+    CHECK( plain.shardCount() == 1 );
+#if defined(OBJECTSLOTS_THREAD_SAFE) && !defined(OBJECTSLOTS_LOCK_FREE)
+    CHECK( Hub(0).shardCount() == 1 );
+    CHECK( Hub(3).shardCount() == 4 );
+    CHECK( Hub(16).shardCount() == 16 );
+    CHECK( Hub(1000).shardCount() == 32 );
+#else
+    // Only builds that lock emits have shards.
+    CHECK( Hub(16).shardCount() == 1 );
+#endif
+}
+
+void testAcrossShards() {
+    Hub hub(8);
+    Counter counter;
+    std::vector<::ObjectSlots::Connection> connections;
+    for( std::size_t i = 0; i < hub.signals.size(); ++i ) {
+        hub[i].bind( &counter, &Counter::onValue );
+        connections.push_back( hub[i].bind( &onValue ) );
+    }
+    hub.bind( &Hub::signal_value, &counter, &Counter::onValue );
+
+    for( std::size_t i = 0; i < hub.signals.size(); ++i ) {
+        hub[i](1);
+    }
+    hub.signal_value(1);
+    CHECK( counter.sum == 17 );
+    CHECK( functionSum == 16 );
+
+    // A handle only locks the shard of its own signal.
+    connections[3].disconnect();
+    CHECK( !connections[3].connected() );
+    CHECK( connections[4].connected() );
+    hub[3](1);
+    hub[4](1);
+    CHECK( functionSum == 17 );
+
+    // Unbinding an object or a function visits every shard.
+    hub.unbind( &counter );
+    hub.unbind( &onValue );
+    for( std::size_t i = 0; i < hub.signals.size(); ++i ) {
+        hub[i](1);
+    }
+    hub.signal_value(1);
+    CHECK( counter.sum == 19 );
+    CHECK( functionSum == 17 );
+    CHECK( !connections[4].connected() );
+
+    // So does a receiver that goes away.
+    {
+        Counter scoped;
+        for( std::size_t i = 0; i < hub.signals.size(); ++i ) {
+            hub[i].bind( &scoped, &Counter::onValue );
+        }
+        hub[0](1);
+        CHECK( scoped.sum == 1 );
+    }
+    for( std::size_t i = 0; i < hub.signals.size(); ++i ) {
+        hub[i](1);
+    }
+}
+
+#if defined(OBJECTSLOTS_THREAD_SAFE) && !defined(OBJECTSLOTS_LOCK_FREE)
+void testWriterDoesNotStallOtherShards() {
+    Hub hub(32);
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    hub[0].bind( [&entered, &release](int) {
+        entered = true;
+        // Bounded, so a regression fails the checks instead of hanging.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while( !release && std::chrono::steady_clock::now() < deadline ) {
+            std::this_thread::yield();
+        }
+    } );
+
+    std::thread emitter([&hub]() { hub[0](1); });
+    while( !entered ) {
+        std::this_thread::yield();
+    }
+
+    // Binds to signals in the shard of the running emit wait for it, the
+    // others complete. With 32 shards some of 15 signals are elsewhere.
+    std::atomic<int> bound{0};
+    std::vector<std::thread> binders;
+    for( std::size_t i = 1; i < hub.signals.size(); ++i ) {
+        binders.emplace_back([&hub, &bound, i]() {
+            hub[i].bind( &onValue );
+            ++bound;
+        });
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while( bound == 0 && std::chrono::steady_clock::now() < deadline ) {
+        std::this_thread::yield();
+    }
+    CHECK( bound > 0 );
+    CHECK( !release );
+
+    release = true;
+    emitter.join();
+    for( auto& binder : binders ) {
+        binder.join();
+    }
+    CHECK( bound == 15 );
+}
+#endif
+
+#ifdef OBJECTSLOTS_THREAD_SAFE
+void testConcurrentSignals() {
+    Hub hub(16);
+    std::atomic<long> nested{0};
+    // A slot that emits a signal of another shard while writers lock several.
+    hub[0].bind( [&hub](int value) { hub[1](value); } );
+    hub[1].bind( [&nested](int value) { nested += value; } );
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> emitters;
+    for( std::size_t t = 0; t < 4; ++t ) {
+        emitters.emplace_back([&hub, &running, t]() {
+            while( running ) {
+                hub[t == 0 ? 0 : t + 1](1);
+                // The shared mutex prefers readers, give the writers a chance.
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<Counter> counters(8);
+    for( int round = 0; round < 50; ++round ) {
+        for( std::size_t i = 0; i < counters.size(); ++i ) {
+            hub[i % hub.signals.size()].bind( &counters[i], &Counter::onValue );
+            hub[(i + 5) % hub.signals.size()].bind( &counters[i], &Counter::onValue );
+        }
+        for( auto& counter : counters ) {
+            hub.unbind( &counter );
+        }
+    }
+    running = false;
+    for( auto& emitter : emitters ) {
+        emitter.join();
+    }
+
+    for( auto& counter : counters ) {
+        const long sum = counter.sum;
+        for( std::size_t i = 0; i < hub.signals.size(); ++i ) {
+            hub[i](1);
+        }
+        CHECK( counter.sum == sum );
+    }
+    const long before = nested;
+    hub[0](1);
+    CHECK( nested == before + 1 );
+}
+#endif
+
+int main(void) {
+    testShardCount();
+    testAcrossShards();
+#if defined(OBJECTSLOTS_THREAD_SAFE) && !defined(OBJECTSLOTS_LOCK_FREE)
+    testWriterDoesNotStallOtherShards();
+#endif
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    testConcurrentSignals();
+#endif
+    return failures == 0 ? 0 : 1;
+}
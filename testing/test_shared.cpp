@@ -0,0 +1,236 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+#include <ObjectSlots/SharedBridge.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+using ObjectSlots::SharedRing;
+using Publisher = ObjectSlots::SharedPublisher<int, double>;
+using Subscriber = ObjectSlots::SharedSubscriber<int, double>;
+using Element = Publisher::Element;
+
+class Sensor : public ObjectSlots::ObjectSlots {
+public:
+    Sensor() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int, double> sample{this};
+};
+
+class Log {
+public:
+    void onSample(int id, double value) {
+        ids.push_back(id);
+        values.push_back(value);
+    }
+    void onBatch(const ::ObjectSlots::Batch<int, double>& batch) {
+        batches.push_back(batch.size());
+        firsts.push_back(batch.data());
+    }
+    std::vector<int> ids;
+    std::vector<double> values;
+    std::vector<std::size_t> batches;
+    std::vector<const Element*> firsts;
+};
+
+std::string ringName(const char* test) {
+    return std::string("/objectslots-") + test + "-" + std::to_string(::getpid());
+}
+
+void testBridge() {
+    const std::string name = ringName("bridge");
+    auto ring = SharedRing::create(name, sizeof(Element), 100);
+    CHECK( ring );
+    CHECK( ring->capacity() == 128 );
+    // A second mapping, at another address, like in another process.
+    auto peer = SharedRing::open(name, sizeof(Element));
+    CHECK( peer );
+    CHECK( !SharedRing::open(name, sizeof(Element) + 8) );
+
+    Sensor sensor, mirror;
+    Publisher publisher(*ring);
+    sensor.sample.bindBatch( &publisher, &Publisher::publish );
+    Log log;
+    mirror.sample.bind( &log, &Log::onSample );
+    mirror.sample.bindBatch( &log, &Log::onBatch );
+    Subscriber subscriber(*peer, mirror.sample);
+    CHECK( subscriber.valid() );
+
+    sensor.sample(1, 0.5);
+    std::vector<Element> batch;
+    for( int i = 2; i <= 10; ++i ) {
+        batch.emplace_back(i, i * 0.5);
+    }
+    sensor.sample.emitBatch(batch);
+    CHECK( subscriber.poll() == 10 );
+    CHECK( log.ids.size() == 10 );
+    CHECK( log.ids.back() == 10 && log.values.back() == 5.0 );
+    // Re-emitted as one batch, read where it lies in the peer's mapping.
+    CHECK( log.batches.size() == 1 && log.batches.front() == 10 );
+    CHECK( log.firsts.front() == peer->element(0) );
+    CHECK( subscriber.poll() == 0 );
+}
+
+void testFullAndWrap() {
+    const std::string name = ringName("full");
+    auto ring = SharedRing::create(name, sizeof(Element), 8);
+    Sensor sensor, mirror;
+    Publisher publisher(*ring);
+    sensor.sample.bindBatch( &publisher, &Publisher::publish );
+    Log log;
+    mirror.sample.bindBatch( &log, &Log::onBatch );
+
+    // Without readers nothing is waited for.
+    CHECK( ring->writable() == 8 );
+    sensor.sample(0, 0.0);
+    Subscriber subscriber(*ring, mirror.sample);
+    CHECK( subscriber.poll() == 0 );
+
+    std::vector<Element> batch(20, Element(1, 1.0));
+    sensor.sample.emitBatch(batch);
+    CHECK( ring->dropped() == 12 );
+    CHECK( ring->writable() == 0 );
+    CHECK( subscriber.poll() == 8 );
+    CHECK( ring->writable() == 8 );
+
+    // The reader started at the second element, these wrap around.
+    sensor.sample.emitBatch(std::vector<Element>(8, Element(2, 2.0)));
+    log.batches.clear();
+    CHECK( subscriber.poll() == 8 );
+    CHECK( log.batches.size() == 2 && log.batches[0] == 7 && log.batches[1] == 1 );
+
+    // Every reader sees every element, the slowest holds the producer back.
+    {
+        Log other;
+        Sensor second;
+        second.sample.bindBatch( &other, &Log::onBatch );
+        Subscriber late(*ring, second.sample);
+        sensor.sample.emitBatch(std::vector<Element>(3, Element(3, 3.0)));
+        CHECK( subscriber.poll() == 3 );
+        CHECK( ring->writable() == 5 );
+        CHECK( late.poll() == 3 );
+    }
+    CHECK( ring->writable() == 8 );
+}
+
+void testReaders() {
+    auto ring = SharedRing::create(ringName("readers"), sizeof(Element), 8);
+    std::vector<std::unique_ptr<SharedRing::Reader>> readers;
+    for( std::size_t i = 0; i < SharedRing::MaxReaders; ++i ) {
+        readers.emplace_back(new SharedRing::Reader(*ring));
+        CHECK( readers.back()->valid() );
+    }
+    SharedRing::Reader extra(*ring);
+    CHECK( !extra.valid() );
+    CHECK( extra.available() == 0 );
+    readers.pop_back();
+    SharedRing::Reader again(*ring);
+    CHECK( again.valid() );
+}
+
+void testWait() {
+    auto ring = SharedRing::create(ringName("wait"), sizeof(Element), 64);
+    Sensor sensor, mirror;
+    Publisher publisher(*ring);
+    sensor.sample.bindBatch( &publisher, &Publisher::publish );
+    Log log;
+    mirror.sample.bind( &log, &Log::onSample );
+    Subscriber subscriber(*ring, mirror.sample);
+
+    CHECK( subscriber.wait(std::chrono::milliseconds(1)) == 0 );
+    std::size_t received = 0;
+    std::thread reader([&subscriber, &received]() {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while( received < 30 && std::chrono::steady_clock::now() < deadline ) {
+            received += subscriber.wait(std::chrono::milliseconds(500));
+        }
+    });
+    for( int i = 0; i < 30; ++i ) {
+        sensor.sample(i, 0.0);
+        if( i % 10 == 0 ) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    reader.join();
+    CHECK( received == 30 );
+    CHECK( log.ids.size() == 30 && log.ids.back() == 29 );
+}
+
+#ifdef __linux__
+void testProcesses() {
+    // Runs first, the child starts with a single thread.
+    const std::string name = ringName("process");
+    auto ring = SharedRing::create(name, sizeof(Element), 16);
+    Sensor mirror;
+    Log log;
+    mirror.sample.bind( &log, &Log::onSample );
+    Subscriber subscriber(*ring, mirror.sample);
+
+    const pid_t child = fork();
+    if( child == 0 ) {
+        auto peer = SharedRing::open(name, sizeof(Element));
+        if( !peer ) {
+            _exit(1);
+        }
+        Sensor sensor;
+        Publisher publisher(*peer);
+        sensor.sample.bindBatch( &publisher, &Publisher::publish );
+        for( int i = 0; i < 100; ) {
+            // Waits for room instead of dropping.
+            if( peer->writable() == 0 ) {
+                std::this_thread::yield();
+                continue;
+            }
+            sensor.sample(i, i * 2.0);
+            ++i;
+        }
+        _exit(peer->dropped() == 0 ? 0 : 2);
+    }
+    CHECK( child > 0 );
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while( log.ids.size() < 100 && std::chrono::steady_clock::now() < deadline ) {
+        subscriber.wait(std::chrono::milliseconds(100));
+    }
+    int status = -1;
+    waitpid(child, &status, 0);
+    CHECK( WIFEXITED(status) && WEXITSTATUS(status) == 0 );
+    CHECK( log.ids.size() == 100 );
+    bool ordered = true;
+    for( std::size_t i = 0; i < log.ids.size(); ++i ) {
+        ordered &= log.ids[i] == int(i) && log.values[i] == i * 2.0;
+    }
+    CHECK( ordered );
+}
+#endif
+
+int main(void) {
+#ifdef __linux__
+    testProcesses();
+#endif
+    testBridge();
+    testFullAndWrap();
+    testReaders();
+    testWait();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Sensor : public ObjectSlots::ObjectSlots {
+public:
+    Sensor() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int, const std::string&> valueChanged{this};
+    ::ObjectSlots::Signal<> reset{this};
+
+    void signal_legacy(int value) {
+        emit( &Sensor::signal_legacy, value );
+    }
+};
+
+class Display : public ObjectSlots::Receiver {
+public:
+    void onValueChanged(int value, const std::string& unit) {
+        text += std::to_string(value) + unit + ";";
+    }
+    void onReset() { ++resets; }
+    void onLegacy(int value) { legacy += value; }
+
+    std::string text;
+    int resets = 0;
+    int legacy = 0;
+};
+
+static int functionCalls = 0;
+
+void onValueChanged(int, const std::string&) {
+    ++functionCalls;
+}
+
+void testBindAndEmit() {
+    Sensor sensor;
+    Display display;
+    std::vector<int> values;
+
+    sensor.valueChanged.bind( &display, &Display::onValueChanged );
+    sensor.valueChanged.bind( &onValueChanged );
+    ::ObjectSlots::Connection lambda = sensor.valueChanged.bind( [&values](int value, const std::string&) { values.push_back(value); } );
+    sensor.reset.bind( &display, &Display::onReset );
+    sensor.bind( &Sensor::signal_legacy, &display, &Display::onLegacy );
+
+    sensor.valueChanged(1, "C");
+    sensor.valueChanged.emit(2, "F");
+    sensor.reset();
+    sensor.signal_legacy(5);
+
+    CHECK( display.text == "1C;2F;" );
+    CHECK( functionCalls == 2 );
+    CHECK( (values == std::vector<int>{ 1, 2 }) );
+    CHECK( display.resets == 1 );
+    CHECK( display.legacy == 5 );
+
+    // Unbinding works across typed and emit() based signals.
+    lambda.disconnect();
+    sensor.unbind( &onValueChanged );
+    sensor.unbind( &display );
+    sensor.valueChanged(3, "K");
+    sensor.reset();
+    sensor.signal_legacy(5);
+    CHECK( display.text == "1C;2F;" );
+    CHECK( functionCalls == 2 );
+    CHECK( values.size() == 2 );
+    CHECK( display.resets == 1 );
+    CHECK( display.legacy == 5 );
+
+    // A signal left without slots can be bound again.
+    sensor.reset.bind( &display, &Display::onReset );
+    sensor.reset();
+    CHECK( display.resets == 2 );
+}
+
+class Dynamic : public ObjectSlots::ObjectSlots {
+public:
+    Dynamic() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+};
+
+void testSignalLifetime() {
+    Dynamic owner;
+    Display display;
+    ::ObjectSlots::Connection connection;
+    {
+        ::ObjectSlots::Signal<> transient(&owner);
+        connection = transient.bind( &display, &Display::onReset );
+        transient();
+        CHECK( connection.connected() );
+    }
+    // A destroyed signal takes its slots with it.
+    CHECK( !connection.connected() );
+    CHECK( display.resets == 1 );
+
+    auto first = std::make_unique<::ObjectSlots::Signal<>>(&owner);
+    auto second = std::make_unique<::ObjectSlots::Signal<>>(&owner);
+    first->bind( &display, &Display::onReset );
+    second->bind( &display, &Display::onReset );
+    first.reset();
+    (*second)();
+    CHECK( display.resets == 2 );
+}
+
+void testReceiverUnbindAll() {
+    Sensor sensor;
+    {
+        Display display;
+        sensor.valueChanged.bind( &display, &Display::onValueChanged );
+        sensor.reset.bind( &display, &Display::onReset );
+    }
+    sensor.valueChanged(1, "C");
+    sensor.reset();
+}
+
+#ifdef OBJECTSLOTS_THREADED
+void testPolicies() {
+    Display display;
+    {
+        Sensor sensor;
+        sensor.valueChanged.bind( &display, &Display::onValueChanged );
+        sensor.setEmitPolicy(Sensor::EmitPolicy::Wait);
+        sensor.valueChanged(1, "C");
+        CHECK( display.text == "1C;" );
+
+        // The owner waits for its detached emits when it is destroyed.
+        sensor.setEmitPolicy(Sensor::EmitPolicy::Detach);
+        sensor.valueChanged(2, "C");
+    }
+    CHECK( display.text == "1C;2C;" );
+}
+#endif
+
+int main(void) {
+    testBindAndEmit();
+    testSignalLifetime();
+    testReceiverUnbindAll();
+#ifdef OBJECTSLOTS_THREADED
+    testPolicies();
+#endif
+    return failures == 0 ? 0 : 1;
+}
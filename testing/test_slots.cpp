@@ -66,8 +66,8 @@ int main(void) {
     test->unbind( &testObject, &TestObject::onHelloMethod );
     test->unbind( &otherSIgnalHandler );
 
-    //test->unbind( lambda );
-    //test->operator()(test_string);
+    test->unbind( lambda );
+    test->operator()(test_string);
 
     delete test;
 
@@ -0,0 +1,204 @@
+#include <iostream>
+
+#include <ObjectSlots/StaticObjectSlots.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+/**
+ * @brief The allocations this thread made through the global operator new,
+ *        the workers of the shared dispatcher start on their own.
+ */
+static thread_local std::size_t heapAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++heapAllocations;
+    if( void* p = std::malloc(size == 0 ? 1 : size) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+class Controller : public ObjectSlots::StaticObjectSlots<4, 8> {
+public:
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_value(int value) {
+        emit( &Controller::signal_value, value );
+    }
+
+    void signal_reset() {
+        emit( &Controller::signal_reset );
+    }
+};
+
+class Sink {
+public:
+    void onValue(int value) { sum += value; }
+    void onReset() { sum = 0; }
+    int sum = 0;
+};
+
+static int functionSum = 0;
+
+void onValue(int value) {
+    functionSum += value;
+}
+
+void testNoHeap() {
+    Controller controller;
+    Sink sinks[6];
+    // The first emit on a thread sets up the thread's own state.
+    controller.signal_value(0);
+
+    const std::size_t before = heapAllocations;
+    std::size_t used = 0;
+    for( int round = 0; round < 100; ++round ) {
+        for( Sink& sink : sinks ) {
+            controller.bind( &Controller::signal_value, &sink, &Sink::onValue );
+            controller.bind( &Controller::signal_reset, &sink, &Sink::onReset );
+        }
+        ::ObjectSlots::Connection function = controller.bind( &Controller::signal_value, &onValue );
+        int local = 0;
+        ::ObjectSlots::Connection typed = controller.typed.bind( [&local](int value) { local += value; } );
+        // Too large to be stored inline, it is kept in the arena.
+        std::array<int, 16> weights{};
+        weights[3] = 2;
+        ::ObjectSlots::Connection weighted = controller.bind( &Controller::signal_value, [&local, weights](int value) { local += weights[3] * value; } );
+
+        controller.signal_value(1);
+        controller.typed(1);
+        CHECK( local == 3 );
+        function.disconnect();
+        weighted.disconnect();
+        controller.signal_reset();
+        for( Sink& sink : sinks ) {
+            controller.unbind( &sink );
+        }
+        typed.disconnect();
+        if( round == 1 ) {
+            used = controller.arena().used();
+        }
+    }
+    CHECK( heapAllocations == before );
+    // Later rounds reuse the blocks the first ones released.
+    CHECK( controller.arena().used() == used );
+    CHECK( functionSum == 100 );
+    CHECK( controller.arena().used() <= controller.arena().capacity() );
+}
+
+class Tiny : public ObjectSlots::StaticObjectSlots<1, 2> {
+public:
+    void signal_tick() {
+        emit( &Tiny::signal_tick );
+    }
+};
+
+static int ticks = 0;
+
+void onTick() {
+    ++ticks;
+}
+
+void testPastCapacity() {
+    Tiny tiny;
+    const std::size_t before = heapAllocations;
+    int bound = 0;
+    bool exhausted = false;
+    try {
+        for( ; bound < 100000; ++bound ) {
+            tiny.bind( &Tiny::signal_tick, &onTick );
+        }
+    } catch( const std::bad_alloc& ) {
+        exhausted = true;
+    }
+    // Binding past the capacity takes more of the arena, never the heap.
+    CHECK( exhausted );
+    CHECK( bound > 2 );
+    CHECK( heapAllocations == before );
+    tiny.signal_tick();
+    CHECK( ticks == bound );
+}
+
+void testArena() {
+    alignas(::ObjectSlots::FixedArena::MaxAlignment) unsigned char buffer[256];
+    ::ObjectSlots::FixedArena arena(buffer, sizeof(buffer));
+    CHECK( ::ObjectSlots::FixedArena::blockSize(1) == 16 );
+    CHECK( ::ObjectSlots::FixedArena::blockSize(33) == 64 );
+
+    void* first = arena.allocate(24, 8);
+    void* second = arena.allocate(24, 8);
+    CHECK( arena.used() == 64 );
+    arena.deallocate(first, 24, 8);
+    // The freed block of the same size is taken first.
+    CHECK( arena.allocate(32, 8) == first );
+    CHECK( arena.used() == 64 );
+
+    void* aligned = arena.allocate(64, 64);
+    CHECK( reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0 );
+    bool exhausted = false;
+    try {
+        static_cast<void>(arena.allocate(256, 8));
+    } catch( const std::bad_alloc& ) {
+        exhausted = true;
+    }
+    CHECK( exhausted );
+    arena.deallocate(second, 24, 8);
+    arena.deallocate(aligned, 64, 64);
+}
+
+void testCapacity() {
+    // Regular emitters may be sized up front as well.
+    class Sized : public ::ObjectSlots::ObjectSlots {
+    public:
+        Sized() : ObjectSlots(Capacity{ 2, 16 }) {
+#ifdef OBJECTSLOTS_THREADED
+            setEmitPolicy(EmitPolicy::Inline);
+#endif
+        }
+        void signal_value(int value) {
+            emit( &Sized::signal_value, value );
+        }
+    };
+    Sized sized;
+    Sink sinks[20];
+    for( Sink& sink : sinks ) {
+        sized.bind( &Sized::signal_value, &sink, &Sink::onValue );
+    }
+    sized.signal_value(2);
+    for( Sink& sink : sinks ) {
+        CHECK( sink.sum == 2 );
+    }
+    sized.unbind( &sinks[0] );
+    sized.signal_value(1);
+    CHECK( sinks[0].sum == 2 && sinks[1].sum == 3 );
+}
+
+int main(void) {
+    testNoHeap();
+    testPastCapacity();
+    testArena();
+    testCapacity();
+    return failures == 0 ? 0 : 1;
+}
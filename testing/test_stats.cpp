@@ -0,0 +1,145 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+#ifdef OBJECTSLOTS_STATS
+class Source : public ::ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_fast(int value) {
+        emit( &Source::signal_fast, value );
+    }
+
+    void signal_slow(int value) {
+        emit( &Source::signal_slow, value );
+    }
+
+    ::ObjectSlots::Signal<int> typed{this};
+};
+
+class Sink {
+public:
+    void onFast(int value) { sum += value; }
+    void onSlow(int) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+    int sum = 0;
+};
+
+const ::ObjectSlots::SignalStats* find(const std::vector<::ObjectSlots::SignalStats>& stats, const void* signal) {
+    for( const auto& entry : stats ) {
+        if( entry.signal == signal ) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void testCounters() {
+    Source source;
+    Sink sink;
+    source.bind( &Source::signal_fast, &sink, &Sink::onFast );
+    source.bind( &Source::signal_fast, &sink, &Sink::onFast );
+    source.bind( &Source::signal_slow, &sink, &Sink::onSlow );
+    source.typed.bind( &sink, &Sink::onFast );
+
+    for( int i = 0; i < 10; ++i ) {
+        source.signal_fast(1);
+    }
+    source.signal_slow(0);
+    source.typed.emitBatch(std::vector<std::tuple<int>>(5, std::tuple<int>(1)));
+
+    const auto stats = source.stats();
+    const auto* fast = find(stats, Source::signalId(&Source::signal_fast));
+    const auto* slow = find(stats, Source::signalId(&Source::signal_slow));
+    const auto* typed = find(stats, &source.typed);
+    CHECK( fast && slow && typed );
+    if( !fast || !slow || !typed ) {
+        return;
+    }
+    CHECK( fast->emits == 10 );
+    CHECK( fast->slots.size() == 2 );
+    for( const auto& slot : fast->slots ) {
+        CHECK( slot.object == &sink );
+        CHECK( slot.invocations == 10 );
+        CHECK( slot.latency.count() == 10 );
+    }
+    CHECK( slow->emits == 1 );
+    CHECK( slow->slots.size() == 1 );
+    CHECK( slow->slots[0].nanoseconds >= 2000000 );
+    CHECK( slow->slots[0].latency.percentile(0.5) >= 2000000 );
+
+    // A batch is timed as one call covering all of its emits.
+    CHECK( typed->emits == 5 );
+    CHECK( typed->slots[0].invocations == 5 );
+    CHECK( typed->slots[0].latency.count() == 1 );
+
+    source.resetStats();
+    const auto reset = source.stats();
+    CHECK( find(reset, Source::signalId(&Source::signal_fast))->emits == 0 );
+    CHECK( find(reset, Source::signalId(&Source::signal_fast))->slots[0].invocations == 0 );
+}
+
+void testReusedConnection() {
+    Source source;
+    Sink sink;
+    std::vector< ::ObjectSlots::Connection > connections;
+    for( int i = 0; i < 200; ++i ) {
+        connections.push_back(source.bind( &Source::signal_fast, &sink, &Sink::onFast ));
+    }
+    source.signal_fast(1);
+    for( auto& connection : connections ) {
+        connection.disconnect();
+    }
+    // The counters of a reused connection start from zero.
+    source.bind( &Source::signal_fast, &sink, &Sink::onFast );
+    const auto stats = source.stats();
+    const auto* fast = find(stats, Source::signalId(&Source::signal_fast));
+    CHECK( fast && fast->slots.size() == 1 && fast->slots[0].invocations == 0 );
+    CHECK( sink.sum == 200 );
+}
+
+void testHistogram() {
+    using Histogram = ::ObjectSlots::LatencyHistogram;
+    CHECK( Histogram::bucket(0) == 0 );
+    CHECK( Histogram::bucket(1) == 0 );
+    CHECK( Histogram::bucket(2) == 1 );
+    CHECK( Histogram::bucket(1023) == 9 );
+    CHECK( Histogram::bucket(1024) == 10 );
+    CHECK( Histogram::bucket(~std::uint64_t(0)) == Histogram::Buckets - 1 );
+
+    Histogram histogram;
+    histogram.counts[3] = 90;
+    histogram.counts[10] = 10;
+    CHECK( histogram.count() == 100 );
+    CHECK( histogram.percentile(0.5) == 16 );
+    CHECK( histogram.percentile(0.99) == 2048 );
+}
+#endif
+
+int main(void) {
+#ifdef OBJECTSLOTS_STATS
+    testCounters();
+    testReusedConnection();
+    testHistogram();
+#endif
+    return failures == 0 ? 0 : 1;
+}
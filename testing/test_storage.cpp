@@ -0,0 +1,196 @@
+#include <iostream>
+
+#include <ObjectSlots/ConnectionPool.hpp>
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    explicit Source(std::pmr::memory_resource* resource) : ObjectSlots(resource) {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+};
+
+class Sink {
+public:
+    void onValue(int value) { sum += value; }
+    int sum = 0;
+};
+
+static int functionSum = 0;
+
+void onValue(int value) {
+    functionSum += value;
+}
+
+void testInlineLayout() {
+    using Method = ::ObjectSlots::SlotMethod<Sink, void, int>;
+    using Function = ::ObjectSlots::SlotFunction<void, int>;
+    int local = 0;
+    auto small = [&local](int value) { local += value; };
+    std::string text("does not fit");
+    auto large = [text](int) { };
+
+    CHECK( ::ObjectSlots::SlotStorage::fitsInline<Method> );
+    CHECK( ::ObjectSlots::SlotStorage::fitsInline<Function> );
+    CHECK( ::ObjectSlots::SlotStorage::fitsInline<decltype(small)> );
+    CHECK( !::ObjectSlots::SlotStorage::fitsInline<decltype(large)> );
+}
+
+void testEmitToEveryKind() {
+    Source source;
+    Sink sink;
+    int lambdaSum = 0;
+    std::string prefix("value ");
+    std::string log;
+    int counter = 0;
+
+    auto small = [&lambdaSum](int value) { lambdaSum += value; };
+    auto large = [prefix, &log](int value) { log += prefix + std::to_string(value) + ";"; };
+    auto counting = [counter](int) mutable { ++counter; return counter; };
+
+    source.bind( &Source::signal_value, &sink, &Sink::onValue );
+    source.bind( &Source::signal_value, &onValue );
+    source.bind( &Source::signal_value, small );
+    source.bind( &Source::signal_value, large );
+    source.bind( &Source::signal_value, [&counting](int value) { counting(value); } );
+
+    source.signal_value(2);
+    source.signal_value(3);
+
+    CHECK( sink.sum == 5 );
+    CHECK( functionSum == 5 );
+    CHECK( lambdaSum == 5 );
+    CHECK( log == "value 2;value 3;" );
+    CHECK( counting(0) == 3 );
+
+    source.unbind( &sink, &Sink::onValue );
+    source.unbind( &onValue );
+    source.signal_value(1);
+    CHECK( sink.sum == 5 );
+    CHECK( functionSum == 5 );
+    CHECK( lambdaSum == 6 );
+}
+
+void testCallableIdentity() {
+    Source source;
+    int temporaries = 0;
+    int named = 0;
+    std::string padding("kept on the heap");
+
+    // Temporaries have no identity, binding two of them keeps both.
+    source.bind( &Source::signal_value, [&temporaries](int value) { temporaries += value; } );
+    ::ObjectSlots::Connection large = source.bind( &Source::signal_value, [&temporaries, padding](int value) {
+        temporaries += value * static_cast<int>(padding.size());
+        return padding.size();
+    } );
+    auto variable = [&named](int value) { named += value; };
+    source.bind( &Source::signal_value, variable );
+    source.signal_value(1);
+    CHECK( temporaries == 17 );
+    CHECK( named == 1 );
+
+    source.unbind( variable );
+    source.signal_value(1);
+    CHECK( temporaries == 34 );
+    CHECK( named == 1 );
+
+    large.disconnect();
+    source.signal_value(1);
+    CHECK( temporaries == 35 );
+}
+
+/**
+ * @brief Counts what is still allocated through it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t live = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        ++live;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        --live;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void testMemoryResource() {
+    CountingResource counting;
+    {
+        Source source(&counting);
+        Sink sink;
+        std::string text("heap allocated ");
+        std::string log;
+        auto large = [text, &log](int value) { log += text + std::to_string(value); };
+
+        CHECK( source.resource() == &counting );
+        source.bind( &Source::signal_value, &sink, &Sink::onValue );
+        source.bind( &Source::signal_value, large );
+        CHECK( counting.allocations > 0 );
+
+        source.signal_value(4);
+        CHECK( sink.sum == 4 );
+        CHECK( log == "heap allocated 4" );
+
+        source.unbind( &sink );
+        source.signal_value(1);
+        CHECK( sink.sum == 4 );
+    }
+    CHECK( counting.live == 0 );
+
+    ::ObjectSlots::ConnectionPool pool(&counting);
+    {
+        Source first(&pool);
+        Source second(&pool);
+        Sink sink;
+        for( int i = 0; i < 32; ++i ) {
+            first.bind( &Source::signal_value, &sink, &Sink::onValue );
+            second.bind( &Source::signal_value, &onValue );
+        }
+        first.signal_value(1);
+        CHECK( sink.sum == 32 );
+    }
+    CHECK( pool.upstream() == &counting );
+}
+
+int main(void) {
+    testInlineLayout();
+    testEmitToEveryKind();
+    testCallableIdentity();
+    testMemoryResource();
+    return failures == 0 ? 0 : 1;
+}
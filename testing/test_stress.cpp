@@ -0,0 +1,417 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs emits, binds, unbinds and receiver destruction against each other for
+// a while and checks that no slot was lost, called twice or called on a dead
+// object. Each scenario reports its emit throughput and latency percentiles.
+// The first argument sets the time per scenario in milliseconds, 200 by
+// default; build with OBJECTSLOTS_SANITIZER to run it under TSan or ASan.
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+using Clock = std::chrono::steady_clock;
+
+static std::chrono::milliseconds duration{200};
+
+class Bus : public ObjectSlots::ObjectSlots {
+public:
+    Bus() : ObjectSlots(Shards{4}) { }
+
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_tick(int amount) {
+        emit( &Bus::signal_tick, amount );
+    }
+};
+
+static std::atomic<long> ticks{0};
+
+void onTick(int amount) {
+    ticks.fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief The emit latencies of one thread, in nanoseconds.
+ */
+class Latencies {
+public:
+    Latencies() { samples_.reserve(1 << 16); }
+
+    template<class F>
+    void measure(F&& call) {
+        const Clock::time_point start = Clock::now();
+        call();
+        // Every 16th emit is kept, enough for the 99.9th percentile of a short run.
+        if( (count_++ & 15) == 0 ) {
+            samples_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+    }
+
+    void merge(Latencies& into) const {
+        into.samples_.insert(into.samples_.end(), samples_.begin(), samples_.end());
+        into.count_ += count_;
+    }
+
+    /**
+     * @brief Prints the throughput, and that of the other threads' `rounds`, and the latency percentiles.
+     */
+    void report(const char* scenario, Clock::duration elapsed, long rounds = 0) {
+        std::sort(samples_.begin(), samples_.end());
+        const auto percentile = [this](double p) -> long long {
+            if( samples_.empty() ) {
+                return 0;
+            }
+            return samples_[static_cast<std::size_t>(p * static_cast<double>(samples_.size() - 1))];
+        };
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << scenario << ": " << static_cast<long>(static_cast<double>(count_) / seconds) << " emits/s";
+        if( rounds > 0 ) {
+            std::cout << ", " << static_cast<long>(static_cast<double>(rounds) / seconds) << " rounds/s";
+        }
+        std::cout << ", p50 " << percentile(0.5) << " ns, p99 " << percentile(0.99)
+                  << " ns, p99.9 " << percentile(0.999) << " ns, max " << percentile(1.0) << " ns" << std::endl;
+    }
+
+private:
+    std::vector<long long> samples_;
+    long count_ = 0;
+};
+
+/**
+ * @brief Runs `emitter(latencies)` on `emitters` threads and `worker(index)`
+ *        on `workers` threads, all of them until `running` is cleared.
+ */
+template<class Emitter, class Worker>
+void run(const char* scenario, std::atomic<bool>& running, int emitters, int workers, Emitter&& emitter, Worker&& worker) {
+    std::vector<Latencies> latencies(static_cast<std::size_t>(emitters));
+    std::vector<std::thread> threads;
+    const Clock::time_point start = Clock::now();
+    for( int i = 0; i < emitters; ++i ) {
+        threads.emplace_back([&emitter, &running, &latencies, i]() {
+            while( running.load(std::memory_order_relaxed) ) {
+                emitter(latencies[static_cast<std::size_t>(i)]);
+                // The shared mutex prefers readers, give the writers a chance.
+                std::this_thread::yield();
+            }
+        });
+    }
+    std::atomic<long> rounds{0};
+    for( int i = 0; i < workers; ++i ) {
+        threads.emplace_back([&worker, &running, &rounds, i]() {
+            while( running.load(std::memory_order_relaxed) ) {
+                worker(i);
+                rounds.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+        });
+    }
+    std::this_thread::sleep_for(duration);
+    running = false;
+    for( std::thread& thread : threads ) {
+        thread.join();
+    }
+    Latencies total;
+    for( const Latencies& thread : latencies ) {
+        thread.merge(total);
+    }
+    total.report(scenario, Clock::now() - start, rounds);
+}
+
+/**
+ * @brief Sets a policy on the emitter, threaded builds run every scenario once per policy.
+ */
+struct Policy {
+    const char* name;
+#ifdef OBJECTSLOTS_THREADED
+    Bus::EmitPolicy policy;
+#endif
+
+    void apply(Bus& bus) const {
+#ifdef OBJECTSLOTS_THREADED
+        bus.setEmitPolicy(policy);
+#else
+        static_cast<void>(bus);
+#endif
+    }
+
+    /** @brief True if `emit()` returns only after its slots ran. */
+    bool waits() const {
+#ifdef OBJECTSLOTS_THREADED
+        return policy != Bus::EmitPolicy::Detach;
+#else
+        return true;
+#endif
+    }
+};
+
+#ifdef OBJECTSLOTS_THREADED
+static const Policy policies[] = {
+    { "inline", Bus::EmitPolicy::Inline },
+    { "wait", Bus::EmitPolicy::Wait },
+    { "parallel", Bus::EmitPolicy::Parallel },
+    { "detach", Bus::EmitPolicy::Detach },
+};
+#else
+static const Policy policies[] = {
+    { "inline" },
+};
+#endif
+
+/**
+ * @brief A receiver that knows whether it is still alive when its slot runs.
+ */
+class Watcher : public ObjectSlots::Trackable {
+public:
+    static constexpr unsigned Alive = 0x5a17e5u;
+
+    explicit Watcher(std::atomic<long>& dead) : dead_(dead) { }
+
+    ~Watcher() {
+        expire();
+        state_.store(0, std::memory_order_relaxed);
+    }
+
+    void onTick(int) {
+        if( state_.load(std::memory_order_relaxed) != Alive ) {
+            dead_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<long>& dead_;
+    std::atomic<unsigned> state_{Alive};
+};
+
+/**
+ * @brief Like `Watcher`, but unbound from its emitters when destroyed.
+ */
+class Member : public ObjectSlots::Receiver {
+public:
+    explicit Member(std::atomic<long>& dead) : dead_(dead) { }
+
+    ~Member() {
+        unbindAll();
+        state_.store(0, std::memory_order_relaxed);
+    }
+
+    void onTick(int) {
+        if( state_.load(std::memory_order_relaxed) != Watcher::Alive ) {
+            dead_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<long>& dead_;
+    std::atomic<unsigned> state_{Watcher::Alive};
+};
+
+#ifdef OBJECTSLOTS_THREAD_SAFE
+static int emitterThreads() {
+    return static_cast<int>(std::max(2u, std::min(8u, std::thread::hardware_concurrency() / 2)));
+}
+
+/**
+ * @brief Emits while other threads bind and unbind slots through handles,
+ *        none of them may be called once every handle is disconnected.
+ */
+void testChurn(const Policy& policy) {
+    std::atomic<long> churned{0};
+    std::atomic<long> stale{0};
+    Bus bus;
+    policy.apply(bus);
+    bus.bind( &Bus::signal_tick, &onTick );
+    bus.typed.bind( &onTick );
+
+    std::atomic<bool> running{true};
+    const std::string scenario = std::string("churn/") + policy.name;
+    run(scenario.c_str(), running, emitterThreads(), 2,
+        [&bus](Latencies& latencies) {
+            latencies.measure([&bus]() {
+                bus.signal_tick(1);
+                bus.typed(1);
+            });
+        },
+        [&bus, &churned, &stale](int worker) {
+            std::vector<::ObjectSlots::Connection> connections;
+            for( int i = 0; i < 32; ++i ) {
+                const auto slot = [&churned](int amount) {
+                    churned.fetch_add(amount, std::memory_order_relaxed);
+                };
+                connections.push_back( worker == 0 ? bus.bind( &Bus::signal_tick, slot ) : bus.typed.bind( slot ) );
+            }
+            for( ::ObjectSlots::Connection& connection : connections ) {
+                connection.disconnect();
+                if( connection.connected() ) {
+                    ++stale;
+                }
+            }
+        });
+
+    CHECK( stale == 0 );
+
+    // Detached invocations of earlier emits may still be running.
+    if( policy.waits() ) {
+        ticks = 0;
+        const long before = churned;
+        bus.signal_tick(1);
+        bus.typed(1);
+        CHECK( ticks == 2 );
+        CHECK( churned == before );
+    }
+}
+
+/**
+ * @brief Counts the emits exactly while slots are bound and unbound, the
+ *        slot bound the whole time must have been called once per emit.
+ */
+void testExactCount(const Policy& policy) {
+    std::atomic<long> emits{0};
+    {
+        Bus bus;
+        policy.apply(bus);
+        bus.bind( &Bus::signal_tick, &onTick );
+        ticks = 0;
+
+        std::atomic<bool> running{true};
+        const std::string scenario = std::string("count/") + policy.name;
+        run(scenario.c_str(), running, emitterThreads(), 2,
+            [&bus, &emits](Latencies& latencies) {
+                latencies.measure([&bus]() { bus.signal_tick(1); });
+                emits.fetch_add(1, std::memory_order_relaxed);
+            },
+            [&bus](int) {
+                // Each thread unbinds its own slots, 16 at a time.
+                static thread_local std::vector<::ObjectSlots::Connection> connections;
+                connections.push_back( bus.bind( &Bus::signal_tick, [](int) { } ) );
+                if( connections.size() == 16 ) {
+                    for( ::ObjectSlots::Connection& connection : connections ) {
+                        bus.unbind( connection );
+                    }
+                    connections.clear();
+                }
+            });
+    }
+    // Also after detached emits, the destroyed emitter waited for them.
+    CHECK( ticks == emits );
+}
+
+/**
+ * @brief Creates, binds and destroys receivers while other threads emit:
+ *        no slot may run on a receiver that was destroyed.
+ */
+template<class Target>
+void testDestruction(const Policy& policy, const char* kind) {
+    std::atomic<long> dead{0};
+    std::atomic<long> created{0};
+    {
+        Bus bus;
+        policy.apply(bus);
+        std::atomic<bool> running{true};
+        const std::string scenario = std::string("destroy-") + kind + "/" + policy.name;
+        run(scenario.c_str(), running, emitterThreads(), 2,
+            [&bus](Latencies& latencies) {
+                latencies.measure([&bus]() {
+                    bus.signal_tick(1);
+                    bus.typed(1);
+                });
+            },
+            [&bus, &dead, &created](int) {
+                std::vector<std::unique_ptr<Target>> receivers;
+                for( int i = 0; i < 8; ++i ) {
+                    receivers.emplace_back(new Target(dead));
+                    bus.bind( &Bus::signal_tick, receivers.back().get(), &Target::onTick );
+                    bus.typed.bind( receivers.back().get(), &Target::onTick );
+                }
+                created += 8;
+                // Destroyed in the middle of the emits of other threads.
+                receivers.clear();
+            });
+    }
+    CHECK( created > 0 );
+    CHECK( dead == 0 );
+}
+#endif
+
+/**
+ * @brief The single-threaded variant: emits from a slot that binds, unbinds
+ *        and destroys receivers of the emitter it runs on.
+ */
+void testReentrantChurn() {
+    std::atomic<long> dead{0};
+    Bus bus;
+    policies[0].apply(bus);
+    std::vector<std::unique_ptr<Watcher>> watchers;
+    std::vector<::ObjectSlots::Connection> connections;
+    bus.bind( &Bus::signal_tick, &onTick );
+    bus.typed.bind( [&](int amount) {
+        if( amount % 3 == 0 && !watchers.empty() ) {
+            watchers.erase(watchers.begin());
+        }
+        if( connections.size() > 32 ) {
+            connections.front().disconnect();
+            connections.erase(connections.begin());
+        }
+        watchers.emplace_back(new Watcher(dead));
+        bus.bind( &Bus::signal_tick, watchers.back().get(), &Watcher::onTick );
+        connections.push_back( bus.bind( &Bus::signal_tick, [](int) { } ) );
+        // Nested, on the emitter whose slots are being changed.
+        bus.signal_tick(1);
+    } );
+    ticks = 0;
+
+    Latencies latencies;
+    const Clock::time_point start = Clock::now();
+    int amount = 0;
+    while( Clock::now() - start < duration ) {
+        for( int i = 0; i < 64; ++i ) {
+            ++amount;
+            latencies.measure([&bus, amount]() { bus.typed(amount); });
+            if( watchers.size() > 32 ) {
+                watchers.clear();
+            }
+        }
+    }
+    latencies.report("reentrant", Clock::now() - start);
+    CHECK( ticks == amount );
+    CHECK( dead == 0 );
+}
+
+int main(int argc, char** argv) {
+    if( argc > 1 ) {
+        duration = std::chrono::milliseconds(std::atol(argv[1]));
+    }
+    testReentrantChurn();
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    for( const Policy& policy : policies ) {
+        testChurn(policy);
+        testExactCount(policy);
+        testDestruction<Watcher>(policy, "tracked");
+#ifndef OBJECTSLOTS_LOCK_FREE
+        // Lock-free emits that already started still call slots unbound
+        // meanwhile, and detached ones run after the unbind returned.
+        if( policy.waits() ) {
+            testDestruction<Member>(policy, "receiver");
+        }
+#endif
+    }
+#endif
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+#include <ObjectSlots/Trace.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+};
+
+static std::size_t occurrences(const std::string& text, const std::string& pattern) {
+    std::size_t count = 0;
+    for( std::size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1) ) {
+        ++count;
+    }
+    return count;
+}
+
+static std::string written() {
+    std::ostringstream out;
+    ::ObjectSlots::Trace::writeChromeJson(out);
+    return out.str();
+}
+
+void testManualSpans() {
+    ::ObjectSlots::Trace::clear();
+    std::thread worker([]() {
+        ::ObjectSlots::Trace::nameThread("worker \"one\"");
+        ::ObjectSlots::TraceScope scope("work");
+    });
+    worker.join();
+    {
+        ::ObjectSlots::TraceScope scope("main");
+    }
+
+    const std::string json = written();
+    CHECK( json.find("\"traceEvents\":[") != std::string::npos );
+    CHECK( occurrences(json, "\"name\":\"work\",\"ph\":\"B\"") == 1 );
+    CHECK( occurrences(json, "\"name\":\"work\",\"ph\":\"E\"") == 1 );
+    CHECK( occurrences(json, "\"name\":\"main\",\"ph\":\"B\"") == 1 );
+    CHECK( json.find("\"args\":{\"name\":\"worker \\\"one\\\"\"}") != std::string::npos );
+
+    ::ObjectSlots::Trace::clear();
+    CHECK( written().find("\"ph\":\"B\"") == std::string::npos );
+}
+
+void testRingKeepsNewest() {
+    ::ObjectSlots::Trace::clear();
+    std::thread worker([]() {
+        ::ObjectSlots::Trace::begin("old");
+        for( std::size_t i = 0; i < ::ObjectSlots::Trace::BufferSize; ++i ) {
+            ::ObjectSlots::Trace::begin("new");
+        }
+    });
+    worker.join();
+
+    const std::string json = written();
+    CHECK( json.find("\"old\"") == std::string::npos );
+    CHECK( occurrences(json, "\"name\":\"new\"") == ::ObjectSlots::Trace::BufferSize );
+    ::ObjectSlots::Trace::clear();
+}
+
+#ifdef OBJECTSLOTS_TRACING
+void testEmitSpans() {
+    ::ObjectSlots::Trace::clear();
+    Source source;
+    int sum = 0;
+    source.bind( &Source::signal_value, [&sum](int value) { sum += value; } );
+    source.bind( &Source::signal_value, [&sum](int value) { sum -= 2 * value; } );
+    source.signal_value(3);
+    CHECK( sum == -3 );
+
+    const std::string json = written();
+    CHECK( occurrences(json, "\"name\":\"emit\",\"ph\":\"B\"") == 1 );
+    CHECK( occurrences(json, "\"name\":\"emit\",\"ph\":\"E\"") == 1 );
+    CHECK( occurrences(json, "\"name\":\"slot\",\"ph\":\"B\"") == 2 );
+    CHECK( occurrences(json, "\"name\":\"slot\",\"ph\":\"E\"") == 2 );
+    // The slots run inside the emit.
+    CHECK( json.find("\"name\":\"emit\",\"ph\":\"E\"") > json.rfind("\"name\":\"slot\",\"ph\":\"E\"") );
+    ::ObjectSlots::Trace::clear();
+}
+#endif
+
+int main(void) {
+    testManualSpans();
+    testRingKeepsNewest();
+#ifdef OBJECTSLOTS_TRACING
+    testEmitSpans();
+#endif
+    return failures == 0 ? 0 : 1;
+}
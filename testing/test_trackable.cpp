@@ -0,0 +1,216 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+
+    int signal_cost(int value) {
+        return collect( &Source::signal_cost, ::ObjectSlots::Sum<int>(), value );
+    }
+};
+
+static int calls = 0;
+
+class Watcher : public ObjectSlots::Trackable {
+public:
+    void onValue(int value) { sum += value; ++calls; }
+    int cost(int value) { return value; }
+    int sum = 0;
+};
+
+void testSkipsDeadReceivers() {
+    calls = 0;
+    Source source;
+    Watcher kept;
+    auto dropped = std::make_unique<Watcher>();
+    ::ObjectSlots::Connection live = source.bind( &Source::signal_value, &kept, &Watcher::onValue );
+    ::ObjectSlots::Connection dead = source.bind( &Source::signal_value, dropped.get(), &Watcher::onValue );
+    source.typed.bind( dropped.get(), &Watcher::onValue );
+    source.signal_value(1);
+    CHECK( calls == 2 );
+
+    // Destroying it unbinds nothing, the emits skip it.
+    dropped.reset();
+    CHECK( source.connected(dead) );
+    source.signal_value(1);
+    CHECK( calls == 3 );
+    CHECK( kept.sum == 2 );
+    // The emit that found it dead unbound it once it returned.
+    CHECK( !source.connected(dead) );
+    CHECK( source.connected(live) );
+    source.typed(1);
+    CHECK( calls == 3 );
+}
+
+void testUnbind() {
+    calls = 0;
+    Source source;
+    Watcher watcher;
+    source.bind( &Source::signal_value, &watcher, &Watcher::onValue );
+    source.bind( &Source::signal_value, &watcher, &Watcher::onValue );
+    // Tracked slots are unbound by object and method as usual.
+    source.unbind( &watcher, &Watcher::onValue );
+    source.signal_value(1);
+    CHECK( calls == 0 );
+    source.bind( &Source::signal_value, &watcher, &Watcher::onValue );
+    source.unbind( &watcher );
+    source.signal_value(1);
+    CHECK( calls == 0 );
+}
+
+void testCopies() {
+    calls = 0;
+    Source source;
+    Watcher original;
+    auto copy = std::make_unique<Watcher>(original);
+    CHECK( copy->liveness() != original.liveness() );
+    source.bind( &Source::signal_value, &original, &Watcher::onValue );
+    source.bind( &Source::signal_value, copy.get(), &Watcher::onValue );
+    copy.reset();
+    source.signal_value(1);
+    CHECK( calls == 1 );
+    CHECK( original.liveness()->alive() );
+}
+
+void testValueSlots() {
+    Source source;
+    Watcher watcher;
+    // Not tracked, they are unbound as before.
+    ::ObjectSlots::Connection connection = source.bind( &Source::signal_cost, &watcher, &Watcher::cost );
+    CHECK( source.signal_cost(3) == 3 );
+    connection.disconnect();
+    CHECK( source.signal_cost(3) == 0 );
+}
+
+class Owner : public ObjectSlots::Trackable {
+public:
+    explicit Owner(std::unique_ptr<Owner>& self) : self_(self) { }
+    // Destroys itself, the own call is not waited for.
+    void onValue(int) { ++calls; self_.reset(); }
+private:
+    std::unique_ptr<Owner>& self_;
+};
+
+void testExpireFromSlot() {
+    calls = 0;
+    Source source;
+    std::unique_ptr<Owner> owner;
+    owner.reset(new Owner(owner));
+    source.bind( &Source::signal_value, owner.get(), &Owner::onValue );
+    source.signal_value(1);
+    CHECK( !owner );
+    source.signal_value(1);
+    CHECK( calls == 1 );
+}
+
+void testQueued() {
+    calls = 0;
+    Source source;
+    ObjectSlots::EventLoop loop;
+    auto watcher = std::make_unique<Watcher>();
+    ::ObjectSlots::Connection connection = source.bind( &Source::signal_value, watcher.get(), &Watcher::onValue, loop );
+    source.signal_value(1);
+    source.signal_value(1);
+    // The events were posted while it lived, they find it gone when they run.
+    watcher.reset();
+    CHECK( loop.processEvents() == 2 );
+    CHECK( calls == 0 );
+    source.signal_value(1);
+    CHECK( loop.processEvents() == 0 );
+    CHECK( !source.connected(connection) );
+}
+
+void testManyDead() {
+    calls = 0;
+    Source source;
+    std::vector<std::unique_ptr<Watcher>> watchers;
+    std::vector<::ObjectSlots::Connection> connections;
+    for( int i = 0; i < 1000; ++i ) {
+        watchers.emplace_back(new Watcher());
+        connections.push_back( source.bind( &Source::signal_value, watchers.back().get(), &Watcher::onValue ) );
+    }
+    for( std::size_t i = 0; i < watchers.size(); i += 2 ) {
+        watchers[i].reset();
+    }
+    source.signal_value(1);
+    CHECK( calls == 500 );
+    std::size_t connected = 0;
+    for( const auto& connection : connections ) {
+        connected += source.connected(connection);
+    }
+    CHECK( connected == 500 );
+}
+
+#ifdef OBJECTSLOTS_THREADED
+class Slow : public ObjectSlots::Trackable {
+public:
+    ~Slow() { expire(); }
+    void onValue(int) {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    }
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+};
+
+void testExpireWaits() {
+    Source source;
+    source.setEmitPolicy(Source::EmitPolicy::Detach);
+    auto slow = std::make_unique<Slow>();
+    source.bind( &Source::signal_value, slow.get(), &Slow::onValue );
+    source.signal_value(1);
+    while( !slow->started ) {
+        std::this_thread::yield();
+    }
+    // Returns once the call running on the worker is over.
+    std::shared_ptr<ObjectSlots::Liveness> liveness = slow->liveness();
+    liveness->expire();
+    CHECK( slow->finished );
+    CHECK( !liveness->alive() );
+    slow.reset();
+    source.signal_value(1);
+}
+#endif
+
+int main(void) {
+    testSkipsDeadReceivers();
+    testUnbind();
+    testCopies();
+    testValueSlots();
+    testExpireFromSlot();
+    testQueued();
+    testManyDead();
+#ifdef OBJECTSLOTS_THREADED
+    testExpireWaits();
+#endif
+    return failures == 0 ? 0 : 1;
+}
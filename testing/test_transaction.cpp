@@ -0,0 +1,217 @@
+#include <iostream>
+
+#include <ObjectSlots/ObjectSlots.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if( !(condition) ) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while( 0 )
+
+class Source : public ObjectSlots::ObjectSlots {
+public:
+    Source() {
+#ifdef OBJECTSLOTS_THREADED
+        setEmitPolicy(EmitPolicy::Inline);
+#endif
+    }
+
+    ::ObjectSlots::Signal<int> typed{this};
+
+    void signal_value(int value) {
+        emit( &Source::signal_value, value );
+    }
+
+    void signal_other(int value) {
+        emit( &Source::signal_other, value );
+    }
+};
+
+using Priority = ::ObjectSlots::ObjectSlots::Priority;
+
+class Recorder {
+public:
+    explicit Recorder(std::string& log, char name) : log_(log), name_(name) { }
+    void onValue(int) { log_ += name_; }
+private:
+    std::string& log_;
+    char name_;
+};
+
+void testCommit() {
+    Source source;
+    std::string log;
+    Recorder a(log, 'a'), b(log, 'b'), c(log, 'c'), d(log, 'd'), e(log, 'e');
+    source.bind( &Source::signal_value, &a, &Recorder::onValue );
+    source.bind( &Source::signal_value, &b, &Recorder::onValue, Priority::Low );
+
+    ::ObjectSlots::Transaction wiring(source);
+    ::ObjectSlots::Connection staged = source.bind( &Source::signal_value, &c, &Recorder::onValue, Priority::High );
+    source.bind( &Source::signal_value, &d, &Recorder::onValue );
+    source.bind( &Source::signal_value, &e, &Recorder::onValue, Priority::Low );
+    source.bind( &Source::signal_value, [&log](int) { log += 'x'; } );
+    source.bind( &Source::signal_other, &e, &Recorder::onValue );
+    // Staged handles are connected, emits only see the slots once committed.
+    CHECK( staged.connected() );
+    source.signal_value(1);
+    source.signal_other(1);
+    CHECK( log == "ab" );
+
+    wiring.commit();
+    log.clear();
+    source.signal_value(1);
+    CHECK( log == "cadxbe" );
+    log.clear();
+    source.signal_other(1);
+    CHECK( log == "e" );
+
+    // Closed, later binds are applied at once.
+    source.bind( &Source::signal_other, &a, &Recorder::onValue );
+    log.clear();
+    source.signal_other(1);
+    CHECK( log == "ea" );
+}
+
+void testUnbind() {
+    Source source;
+    std::string log;
+    Recorder a(log, 'a'), b(log, 'b'), c(log, 'c');
+    ::ObjectSlots::Connection live = source.bind( &Source::signal_value, &a, &Recorder::onValue );
+    {
+        ::ObjectSlots::Transaction wiring(source);
+        ::ObjectSlots::Connection temporary = source.bind( &Source::signal_value, &b, &Recorder::onValue );
+        source.unbind( temporary );
+        // Bound and unbound again, it never reaches the slot array.
+        CHECK( !temporary.connected() );
+        source.unbind( live );
+        source.signal_value(1);
+        CHECK( log == "a" );
+        source.bind( &Source::signal_value, &c, &Recorder::onValue );
+    }
+    CHECK( !live.connected() );
+    log.clear();
+    source.signal_value(1);
+    CHECK( log == "c" );
+}
+
+void testUnbindObject() {
+    Source source;
+    std::string log;
+    Recorder a(log, 'a'), b(log, 'b');
+    source.bind( &Source::signal_value, &a, &Recorder::onValue );
+    {
+        ::ObjectSlots::Transaction wiring(source);
+        ::ObjectSlots::Connection dropped = source.bind( &Source::signal_value, &a, &Recorder::onValue );
+        source.bind( &Source::signal_other, &a, &Recorder::onValue );
+        source.bind( &Source::signal_value, &b, &Recorder::onValue );
+        // Takes effect at once, for the bound slots and the staged ones.
+        source.unbind( &a );
+        CHECK( !dropped.connected() );
+        source.signal_value(1);
+        CHECK( log.empty() );
+        source.bind( &Source::signal_other, &a, &Recorder::onValue );
+    }
+    source.signal_value(1);
+    source.signal_other(1);
+    CHECK( log == "ba" );
+}
+
+void testNested() {
+    Source source;
+    std::string log;
+    Recorder a(log, 'a'), b(log, 'b');
+    {
+        ::ObjectSlots::Transaction outer(source);
+        source.bind( &Source::signal_value, &a, &Recorder::onValue );
+        {
+            ::ObjectSlots::Transaction inner(source);
+            source.typed.bind( &b, &Recorder::onValue );
+        }
+        // The outermost transaction commits.
+        source.signal_value(1);
+        source.typed(1);
+        CHECK( log.empty() );
+    }
+    source.signal_value(1);
+    source.typed(1);
+    CHECK( log == "ab" );
+}
+
+static int sum = 0;
+
+void addValue(int value) {
+    sum += value;
+}
+
+void testMany() {
+    Source source;
+    std::vector<::ObjectSlots::Connection> connections;
+    {
+        ::ObjectSlots::Transaction wiring(source);
+        for( int i = 0; i < 1000; ++i ) {
+            connections.push_back( source.bind( &Source::signal_value, &addValue ) );
+            source.bind( &Source::signal_other, &addValue, i % 2 ? Priority::High : Priority::Low );
+        }
+        for( std::size_t i = 0; i < connections.size(); i += 2 ) {
+            connections[i].disconnect();
+        }
+    }
+    source.signal_value(1);
+    CHECK( sum == 500 );
+    sum = 0;
+    source.signal_other(1);
+    CHECK( sum == 1000 );
+    // Handles refer to the slots they were bound with.
+    for( std::size_t i = 1; i < connections.size(); i += 2 ) {
+        connections[i].disconnect();
+    }
+    sum = 0;
+    source.signal_value(1);
+    CHECK( sum == 0 );
+}
+
+#ifdef OBJECTSLOTS_THREAD_SAFE
+void testThreads() {
+    Source source;
+    std::atomic<int> calls{0};
+    std::vector<std::thread> threads;
+    for( int t = 0; t < 4; ++t ) {
+        threads.emplace_back([&source, &calls]() {
+            for( int round = 0; round < 10; ++round ) {
+                ::ObjectSlots::Transaction wiring(source);
+                for( int i = 0; i < 50; ++i ) {
+                    source.bind( &Source::signal_value, [&calls](int) { ++calls; } );
+                }
+                source.signal_value(0);
+            }
+        });
+    }
+    for( std::thread& thread : threads ) {
+        thread.join();
+    }
+    calls = 0;
+    source.signal_value(1);
+    CHECK( calls == 2000 );
+}
+#endif
+
+int main(void) {
+    testCommit();
+    testUnbind();
+    testUnbindObject();
+    testNested();
+    testMany();
+#ifdef OBJECTSLOTS_THREAD_SAFE
+    testThreads();
+#endif
+    return failures == 0 ? 0 : 1;
+}